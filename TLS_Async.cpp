@@ -0,0 +1,6 @@
+// Asynchronous steady-state driver for the TSP genetic algorithm
+#include "tsp/Driver.h"
+
+int main(int argc, char **argv) {
+    return runTspDriver(argc, argv, ExecutionPolicy::Async);
+}
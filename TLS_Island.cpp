@@ -0,0 +1,6 @@
+// Island-model driver for the TSP genetic algorithm
+#include "tsp/Driver.h"
+
+int main(int argc, char **argv) {
+    return runTspDriver(argc, argv, ExecutionPolicy::Islands);
+}
@@ -0,0 +1,267 @@
+// Benchmark harness for the TSP engines: sweeps execution policies, city counts, population sizes and
+// OpenMP thread counts, and reports generations/s, fitness evaluations/s and the best tour length
+// over time as CSV or JSON.
+//
+// Usage: tsp_bench [--policies serial,omp,task,island,async] [--cities 50,1000,10000] [--population 100]
+//                  [--threads 1,2,4] [--generations 200] [--repeat 3] [--seed 1] [--weak]
+//                  [--instance FILE] [--format csv|json] [--output FILE] [--trace FILE] [--trace-every 10]
+//                  [--config FILE] [operator and island settings, see applyGASettings in tsp/Driver.h]
+//
+// --weak scales the population with the thread count (weak scaling); otherwise the problem size is
+// fixed while the threads vary (strong scaling). The serial policy is run once per size, with one
+// thread. With --instance the given file replaces the random instances of --cities. In CSV mode the
+// best-length-over-time trace goes to the --trace file; in JSON mode it is part of every run.
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <omp.h>
+
+#include "common/Config.h"
+#include "common/Profiler.h"
+#include "tsp/Cities.h"
+#include "tsp/GeneticAlgorithm.h"
+#include "tsp/Driver.h"
+#include "tsp/InstanceLoader.h"
+#include "tsp/TourBatch.h"
+
+struct BenchOptions {
+    std::vector<std::string> policies = {"serial", "omp", "task", "island"};
+    std::vector<long> cities = {50, 1000, 10000};
+    std::vector<long> populations = {GAParameters().populationSize};
+    std::vector<long> threads;
+    int generations = 200;
+    int repeat = 3;
+    uint64_t seed = 1;
+    bool weak = false;
+    std::string instancePath;
+    std::string format = "csv";
+    std::string outputPath;
+    std::string tracePath;
+    int traceEvery = 10;
+    GAParameters base; // mutation, crossover and island settings of every run
+};
+
+struct TracePoint {
+    int generation;
+    double seconds;
+    double bestLength;
+};
+
+struct BenchResult {
+    std::string policy;
+    std::string instance;
+    int threads;
+    size_t cities;
+    int population;
+    int generations;
+    double seconds; // median over the repeats
+    double bestLength;
+    std::vector<TracePoint> trace;
+};
+
+// The comma-separated numbers of --key
+static std::vector<long> getNumbers(const Config &config, const std::string &key) {
+    std::vector<long> numbers;
+    for (const std::string &item: config.getList(key, {})) {
+        numbers.push_back(parseIntOption(key, item));
+    }
+    return numbers;
+}
+
+static void requirePositive(const std::vector<long> &numbers, const std::string &key) {
+    for (long n: numbers) {
+        if (n < 1) throw std::invalid_argument("--" + key + " must be at least 1");
+    }
+}
+
+static BenchOptions parseOptions(int argc, char **argv) {
+    BenchOptions options;
+    Config config = Config::fromCommandLine(argc, argv);
+    if (!config.positional().empty()) {
+        throw std::invalid_argument("unknown argument " + config.positional().front());
+    }
+    options.policies = config.getList("policies", options.policies);
+    if (config.has("cities")) options.cities = getNumbers(config, "cities");
+    if (config.has("population")) options.populations = getNumbers(config, "population");
+    if (config.has("threads")) options.threads = getNumbers(config, "threads");
+    options.generations = static_cast<int>(config.getInt("generations", options.generations));
+    options.repeat = std::max(1, static_cast<int>(config.getInt("repeat", options.repeat)));
+    options.seed = config.getUint64("seed", options.seed);
+    options.weak = config.getBool("weak", options.weak);
+    options.instancePath = config.getString("instance", "");
+    options.format = config.getString("format", options.format);
+    options.outputPath = config.getString("output", "");
+    options.tracePath = config.getString("trace", "");
+    options.traceEvery = std::max(1, static_cast<int>(config.getInt("trace-every", options.traceEvery)));
+    applyGASettings(config, options.base);
+    config.checkUnused();
+    requirePositive(options.cities, "cities");
+    requirePositive(options.populations, "population");
+    requirePositive(options.threads, "threads");
+    if (options.generations < 0) throw std::invalid_argument("--generations must not be negative");
+    if (options.threads.empty()) {
+        for (long t = 1; t < omp_get_max_threads(); t *= 2) options.threads.push_back(t);
+        options.threads.push_back(omp_get_max_threads());
+    }
+    if (options.format != "csv" && options.format != "json") {
+        throw std::invalid_argument("--format must be csv or json");
+    }
+    return options;
+}
+
+static BenchResult runBenchmark(const Instance &instance, ExecutionPolicy policy, int threads, int population,
+                                const BenchOptions &options) {
+    GAParameters params = options.base;
+    params.populationSize = population;
+    params.numGenerations = options.generations;
+    params.seed = options.seed;
+    omp_set_num_threads(threads);
+
+    BenchResult result{executionPolicyName(policy), instance.name, threads, instance.size(), population,
+                       options.generations, 0.0, 0.0, {}};
+    std::vector<double> times;
+    for (int r = 0; r < options.repeat; ++r) {
+        result.trace.clear();
+        auto start = std::chrono::steady_clock::now();
+        auto observer = [&](int generation, const Population &pop) {
+            if (generation % options.traceEvery == 0 || generation == options.generations) {
+                double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                result.trace.push_back({generation, elapsed, pop.length(pop.bestIndex())});
+            }
+        };
+        Route best = runGeneticAlgorithm(instance, params, policy, observer);
+        times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        result.bestLength = best.totalDistance();
+    }
+    std::sort(times.begin(), times.end());
+    result.seconds = times[times.size() / 2];
+    return result;
+}
+
+static void writeCsv(std::ostream &os, const std::vector<BenchResult> &results) {
+    os << "policy,instance,threads,cities,population,generations,seconds,generations_per_sec,"
+          "evaluations_per_sec,best_length\n";
+    for (const BenchResult &r: results) {
+        double evaluations = double(r.population) * (r.generations + 1);
+        os << r.policy << ',' << r.instance << ',' << r.threads << ',' << r.cities << ',' << r.population << ','
+           << r.generations << ',' << r.seconds << ',' << r.generations / r.seconds << ','
+           << evaluations / r.seconds << ',' << r.bestLength << '\n';
+    }
+}
+
+static void writeTraceCsv(std::ostream &os, const std::vector<BenchResult> &results) {
+    os << "policy,instance,threads,cities,population,generation,seconds,best_length\n";
+    for (const BenchResult &r: results) {
+        for (const TracePoint &point: r.trace) {
+            os << r.policy << ',' << r.instance << ',' << r.threads << ',' << r.cities << ',' << r.population << ','
+               << point.generation << ',' << point.seconds << ',' << point.bestLength << '\n';
+        }
+    }
+}
+
+static void writeJson(std::ostream &os, const std::vector<BenchResult> &results) {
+    os << "{\n  \"runs\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult &r = results[i];
+        double evaluations = double(r.population) * (r.generations + 1);
+        os << (i ? "," : "") << "\n    {\"policy\": \"" << r.policy << "\", \"instance\": \"" << r.instance
+           << "\", \"threads\": " << r.threads << ", \"cities\": " << r.cities << ", \"population\": "
+           << r.population << ", \"generations\": " << r.generations << ", \"seconds\": " << r.seconds
+           << ", \"generations_per_sec\": " << r.generations / r.seconds << ", \"evaluations_per_sec\": "
+           << evaluations / r.seconds << ", \"best_length\": " << r.bestLength << ", \"trace\": [";
+        for (size_t k = 0; k < r.trace.size(); ++k) {
+            os << (k ? ", " : "") << "[" << r.trace[k].generation << ", " << r.trace[k].seconds << ", "
+               << r.trace[k].bestLength << "]";
+        }
+        os << "]}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+int main(int argc, char **argv) {
+    BenchOptions options;
+    std::vector<Instance> instances;
+    std::vector<ExecutionPolicy> policies;
+    std::ofstream file;
+    std::ofstream trace;
+    try {
+        options = parseOptions(argc, argv);
+        for (const std::string &name: options.policies) {
+            policies.push_back(parseExecutionPolicy(name));
+        }
+        if (!options.instancePath.empty()) {
+            instances.push_back(loadInstance(options.instancePath));
+        } else {
+            for (long n: options.cities) {
+                instances.emplace_back(randomCities(n, options.seed), "random" + std::to_string(n));
+            }
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    // Opened before the runs, so a bad path does not cost a whole sweep
+    if (!options.outputPath.empty()) {
+        file.open(options.outputPath);
+        if (!file) {
+            std::cerr << "Error: cannot open " << options.outputPath << std::endl;
+            return 1;
+        }
+    }
+    if (options.format == "csv" && !options.tracePath.empty()) {
+        trace.open(options.tracePath);
+        if (!trace) {
+            std::cerr << "Error: cannot open " << options.tracePath << std::endl;
+            return 1;
+        }
+    }
+
+    std::cerr << "tour evaluation kernel: " << tourBatchKernel() << std::endl;
+    std::vector<BenchResult> results;
+    for (const Instance &instance: instances) {
+        for (long basePopulation: options.populations) {
+            for (ExecutionPolicy policy: policies) {
+                for (long threads: options.threads) {
+                    if (policy == ExecutionPolicy::Serial && threads != options.threads.front()) break;
+                    int t = policy == ExecutionPolicy::Serial ? 1 : static_cast<int>(threads);
+                    int population = static_cast<int>(options.weak ? basePopulation * t : basePopulation);
+                    results.push_back(runBenchmark(instance, policy, t, population, options));
+                    const BenchResult &r = results.back();
+                    std::cerr << r.policy << " threads=" << r.threads << " cities=" << r.cities << " population="
+                              << r.population << ": " << r.generations / r.seconds << " generations/s, best "
+                              << r.bestLength << std::endl;
+                }
+            }
+        }
+    }
+
+    writeProfileReport(std::cerr);
+
+    std::ostream &out = options.outputPath.empty() ? std::cout : file;
+    out.precision(10);
+    if (options.format == "json") {
+        writeJson(out, results);
+    } else {
+        writeCsv(out, results);
+        if (trace.is_open()) {
+            trace.precision(10);
+            writeTraceCsv(trace, results);
+            if (!trace.flush()) {
+                std::cerr << "Error: cannot write " << options.tracePath << std::endl;
+                return 1;
+            }
+        }
+    }
+    if (!out.flush()) {
+        std::cerr << "Error: cannot write " << (options.outputPath.empty() ? "the results" : options.outputPath)
+                  << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,137 @@
+#include "common/Config.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+static std::string trim(const std::string &s) {
+    size_t begin = s.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r");
+    return s.substr(begin, end - begin + 1);
+}
+
+Config Config::fromCommandLine(int argc, char **argv) {
+    Config config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--", 0) != 0 || arg.size() == 2) {
+            config.positionalArgs.push_back(arg);
+            continue;
+        }
+        std::string key = arg.substr(2);
+        size_t equals = key.find('=');
+        if (equals != std::string::npos) {
+            config.values[key.substr(0, equals)] = key.substr(equals + 1);
+        } else if (i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0) {
+            config.values[key] = argv[++i];
+        } else {
+            config.values[key] = "true";
+        }
+    }
+    if (config.has("config")) {
+        config.loadFile(config.getString("config", ""));
+    }
+    return config;
+}
+
+void Config::loadFile(const std::string &path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::invalid_argument("cannot open config file " + path);
+    }
+    std::string line;
+    for (int number = 1; std::getline(file, line); ++number) {
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) continue;
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            throw std::invalid_argument(path + ":" + std::to_string(number) + ": expected key = value");
+        }
+        values.emplace(trim(line.substr(0, equals)), trim(line.substr(equals + 1)));
+    }
+}
+
+const std::string *Config::find(const std::string &key) const {
+    auto it = values.find(key);
+    if (it == values.end()) return nullptr;
+    used.insert(key);
+    return &it->second;
+}
+
+bool Config::has(const std::string &key) const {
+    return find(key) != nullptr;
+}
+
+std::string Config::getString(const std::string &key, const std::string &fallback) const {
+    const std::string *value = find(key);
+    return value ? *value : fallback;
+}
+
+// Parse the whole of `text` with a std::sto* function, naming the option on failure
+template<typename T, typename Parse>
+static T parseValue(const std::string &key, const std::string &text, Parse parse) {
+    try {
+        size_t consumed = 0;
+        T value = parse(text, &consumed);
+        if (consumed == text.size()) return value;
+    } catch (const std::exception &) {
+    }
+    throw std::invalid_argument("invalid value '" + text + "' for --" + key);
+}
+
+long parseIntOption(const std::string &key, const std::string &text) {
+    return parseValue<long>(key, text, [](const std::string &s, size_t *n) { return std::stol(s, n); });
+}
+
+long Config::getInt(const std::string &key, long fallback) const {
+    const std::string *value = find(key);
+    if (!value) return fallback;
+    return parseIntOption(key, *value);
+}
+
+uint64_t Config::getUint64(const std::string &key, uint64_t fallback) const {
+    const std::string *value = find(key);
+    if (!value) return fallback;
+    return parseValue<uint64_t>(key, *value, [](const std::string &s, size_t *n) {
+        // std::stoull would wrap "-5" around to 2^64 - 5
+        size_t sign = s.find_first_not_of(" \t\n\v\f\r");
+        if (sign != std::string::npos && s[sign] == '-') throw std::invalid_argument("negative");
+        return std::stoull(s, n);
+    });
+}
+
+double Config::getDouble(const std::string &key, double fallback) const {
+    const std::string *value = find(key);
+    if (!value) return fallback;
+    return parseValue<double>(key, *value, [](const std::string &s, size_t *n) { return std::stod(s, n); });
+}
+
+bool Config::getBool(const std::string &key, bool fallback) const {
+    const std::string *value = find(key);
+    if (!value) return fallback;
+    if (*value == "true" || *value == "1" || *value == "yes" || *value == "on") return true;
+    if (*value == "false" || *value == "0" || *value == "no" || *value == "off") return false;
+    throw std::invalid_argument("invalid value '" + *value + "' for --" + key + " (expected true or false)");
+}
+
+std::vector<std::string> Config::getList(const std::string &key, const std::vector<std::string> &fallback) const {
+    const std::string *value = find(key);
+    if (!value) return fallback;
+    std::vector<std::string> items;
+    std::stringstream stream(*value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        item = trim(item);
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+void Config::checkUnused() const {
+    for (const auto &entry: values) {
+        if (used.count(entry.first) == 0) {
+            throw std::invalid_argument("unknown option --" + entry.first);
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// Run settings gathered from an optional config file and the command line, so engines can be
+// tuned and swept without recompiling.
+//
+// Command line: "--key value", "--key=value", or a bare "--key" (read as "true") when it is last
+// or followed by another option. Anything not starting with "--" is a positional argument.
+// "--config FILE" loads FILE first: one "key = value" per line, '#' starts a comment. Settings on
+// the command line take precedence over the file.
+//
+// Getters convert on demand and throw std::invalid_argument on malformed values; checkUnused()
+// reports keys nobody asked for, which catches misspelled options.
+class Config {
+public:
+    Config() = default;
+
+    static Config fromCommandLine(int argc, char **argv);
+
+    // Merge a config file; keys already set are kept
+    void loadFile(const std::string &path);
+
+    void set(const std::string &key, const std::string &value) { values[key] = value; }
+
+    bool has(const std::string &key) const;
+    std::string getString(const std::string &key, const std::string &fallback) const;
+    long getInt(const std::string &key, long fallback) const;
+    uint64_t getUint64(const std::string &key, uint64_t fallback) const;
+    double getDouble(const std::string &key, double fallback) const;
+    bool getBool(const std::string &key, bool fallback) const;
+    // Comma-separated list
+    std::vector<std::string> getList(const std::string &key, const std::vector<std::string> &fallback) const;
+
+    const std::vector<std::string> &positional() const { return positionalArgs; }
+
+    // Throws std::invalid_argument naming the first key that was set but never read
+    void checkUnused() const;
+
+private:
+    std::map<std::string, std::string> values;
+    std::vector<std::string> positionalArgs;
+    mutable std::set<std::string> used;
+
+    const std::string *find(const std::string &key) const;
+};
+
+// Parse the whole of `text` as an integer for the option --key (e.g. an item of a list or part of
+// a value); throws std::invalid_argument naming the option and the value otherwise
+long parseIntOption(const std::string &key, const std::string &text);
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Read-only memory mapping of a whole file, so parsers can work on its bytes in place
+// without reading them into a buffer first. Throws std::system_error if the file cannot
+// be opened or mapped.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const char *data() const { return bytes; }
+    size_t size() const { return length; }
+    std::string_view view() const { return {bytes, length}; }
+
+private:
+    const char *bytes = nullptr;
+    size_t length = 0;
+};
@@ -0,0 +1,193 @@
+#include "common/Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+const char *profileZoneName(ProfileZone zone) {
+    switch (zone) {
+        case ProfileZone::Initialization:
+            return "initialization";
+        case ProfileZone::Selection:
+            return "selection";
+        case ProfileZone::Crossover:
+            return "crossover";
+        case ProfileZone::Mutation:
+            return "mutation";
+        case ProfileZone::Evaluation:
+            return "evaluation";
+        case ProfileZone::LocalSearch:
+            return "local search";
+        case ProfileZone::Copy:
+            return "copy";
+        case ProfileZone::Replacement:
+            return "replacement";
+        case ProfileZone::Migration:
+            return "migration";
+        case ProfileZone::Checkpoint:
+            return "checkpoint";
+        case ProfileZone::Count:
+            break;
+    }
+    return "unknown";
+}
+
+int profileIntervalFromConfig(const Config &config) {
+    if (!config.has("profile-every")) {
+        return 0;
+    }
+    if (!profilingEnabled()) {
+        throw std::invalid_argument("--profile-every needs a build with the CMake option GA_PROFILE");
+    }
+    long every = config.getInt("profile-every", 0);
+    if (every < 0) throw std::invalid_argument("--profile-every must not be negative");
+    return static_cast<int>(every);
+}
+
+#ifndef GA_PROFILE
+
+void writeProfileReport(std::ostream &) {}
+
+#else
+
+namespace {
+
+// Every thread that ever opened a zone; profiles live until the end of the program, so reports
+// can include threads that have finished
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<profiler_detail::ThreadProfile>> threads;
+};
+
+Registry &registry() {
+    static Registry instance;
+    return instance;
+}
+
+// Reference points for converting ticks to seconds
+const uint64_t START_TICKS = profiler_detail::readTicks();
+const auto START_TIME = std::chrono::steady_clock::now();
+
+double secondsPerTick() {
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - START_TIME).count();
+    uint64_t ticks = profiler_detail::readTicks() - START_TICKS;
+    return ticks > 0 ? seconds / static_cast<double>(ticks) : 0.0;
+}
+
+void countAllocation(size_t size) {
+    // Only threads that are already registered: registering allocates itself
+    if (profiler_detail::ThreadProfile *profile = profiler_detail::threadSlot()) {
+        profiler_detail::ThreadProfile::add(profile->allocations, 1);
+        profiler_detail::ThreadProfile::add(profile->allocatedBytes, size);
+    }
+}
+
+} // namespace
+
+namespace profiler_detail {
+
+ThreadProfile *registerThread() {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.threads.push_back(std::make_unique<ThreadProfile>());
+    return r.threads.back().get();
+}
+
+#if defined(GA_PROFILE_ITT)
+__itt_domain *ittDomain() {
+    static __itt_domain *domain = __itt_domain_create("ga");
+    return domain;
+}
+
+__itt_string_handle *ittName(ProfileZone zone) {
+    static __itt_string_handle *names[static_cast<size_t>(ProfileZone::Count)] = {};
+    static std::once_flag created;
+    std::call_once(created, [] {
+        for (size_t z = 0; z < static_cast<size_t>(ProfileZone::Count); ++z) {
+            names[z] = __itt_string_handle_create(profileZoneName(static_cast<ProfileZone>(z)));
+        }
+    });
+    return names[static_cast<size_t>(zone)];
+}
+#endif
+
+} // namespace profiler_detail
+
+void writeProfileReport(std::ostream &os) {
+    const size_t zones = static_cast<size_t>(ProfileZone::Count);
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    double tick = secondsPerTick();
+
+    uint64_t calls[zones] = {}, total[zones] = {}, self[zones] = {};
+    uint64_t allocations = 0, allocatedBytes = 0;
+    std::vector<double> busy;
+    for (const auto &thread: r.threads) {
+        uint64_t threadSelf = 0;
+        for (size_t z = 0; z < zones; ++z) {
+            calls[z] += thread->calls[z].load(std::memory_order_relaxed);
+            total[z] += thread->totalTicks[z].load(std::memory_order_relaxed);
+            uint64_t s = thread->selfTicks[z].load(std::memory_order_relaxed);
+            self[z] += s;
+            threadSelf += s;
+        }
+        allocations += thread->allocations.load(std::memory_order_relaxed);
+        allocatedBytes += thread->allocatedBytes.load(std::memory_order_relaxed);
+        busy.push_back(static_cast<double>(threadSelf) * tick);
+    }
+    uint64_t allSelf = 0;
+    for (size_t z = 0; z < zones; ++z) allSelf += self[z];
+
+    char line[128];
+    os << "Profile (" << busy.size() << " threads)\n";
+    std::snprintf(line, sizeof(line), "  %-15s %12s %10s %10s %7s %10s\n", "zone", "calls", "total s", "self s",
+                  "self %", "ns/call");
+    os << line;
+    for (size_t z = 0; z < zones; ++z) {
+        if (calls[z] == 0) continue;
+        std::snprintf(line, sizeof(line), "  %-15s %12llu %10.4f %10.4f %6.1f%% %10.1f\n",
+                      profileZoneName(static_cast<ProfileZone>(z)), static_cast<unsigned long long>(calls[z]),
+                      static_cast<double>(total[z]) * tick, static_cast<double>(self[z]) * tick,
+                      allSelf ? 100.0 * static_cast<double>(self[z]) / static_cast<double>(allSelf) : 0.0,
+                      1e9 * static_cast<double>(total[z]) * tick / static_cast<double>(calls[z]));
+        os << line;
+    }
+    os << "  allocations: " << allocations << " (" << static_cast<double>(allocatedBytes) / (1 << 20) << " MiB)\n";
+    if (!busy.empty()) {
+        double sum = 0.0, longest = 0.0;
+        os << "  busy s per thread:";
+        for (double b: busy) {
+            os << ' ' << b;
+            sum += b;
+            longest = std::max(longest, b);
+        }
+        double mean = sum / static_cast<double>(busy.size());
+        os << "\n  load imbalance (max / mean): " << (mean > 0.0 ? longest / mean : 1.0) << '\n';
+    }
+}
+
+// Global allocation functions that count every heap allocation of a registered thread; the
+// array and nothrow forms of the standard library forward to these
+void *operator new(std::size_t size) {
+    countAllocation(size);
+    if (void *p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+#endif
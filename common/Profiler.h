@@ -0,0 +1,168 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "common/Config.h"
+
+#if defined(GA_PROFILE) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#elif defined(GA_PROFILE)
+#include <chrono>
+#endif
+
+#if defined(GA_PROFILE_TRACY)
+#include <tracy/Tracy.hpp>
+#elif defined(GA_PROFILE_ITT)
+#include <ittnotify.h>
+#endif
+
+// Hot-path instrumentation of the GA operators. With the CMake option GA_PROFILE every
+// GA_PROFILE_ZONE in the engines becomes a scoped timer that adds its elapsed time (rdtsc ticks on
+// x86, steady_clock nanoseconds elsewhere) and a call to counters owned by the current thread, so
+// threads never share a cache line; heap allocations are counted per thread too. Without the
+// option the macro expands to nothing and the engines compile exactly as before.
+//
+// Zones may nest: a zone's self time excludes the zones opened inside it, so the self times of a
+// thread add up to its busy time, whose spread over the threads is the load imbalance.
+//
+// GA_PROFILE_TRACY (Tracy) or GA_PROFILE_ITT (VTune's ITT API) additionally emit every zone as a
+// marker for those profilers; both imply GA_PROFILE.
+
+enum class ProfileZone {
+    Initialization, // building and evaluating the initial population
+    Selection,
+    Crossover,
+    Mutation,
+    Evaluation,     // full fitness (tour length) computations
+    LocalSearch,
+    Copy,           // copying individuals between populations
+    Replacement,    // steady-state insertion of children
+    Migration,      // island model emigration and immigration
+    Checkpoint,     // handing a checkpoint to its writer
+    Count
+};
+
+const char *profileZoneName(ProfileZone zone);
+
+constexpr bool profilingEnabled() {
+#ifdef GA_PROFILE
+    return true;
+#else
+    return false;
+#endif
+}
+
+// "profile-every" N of a driver: also report every N generations (0 = only at the end of the run).
+// Throws std::invalid_argument on a negative N or if it is set in a build without GA_PROFILE.
+int profileIntervalFromConfig(const Config &config);
+
+// Time, calls and self share per zone, allocations, and the busy time of every thread with the
+// resulting imbalance (max / mean), accumulated since the start of the program. Threads may still
+// be counting while it is written.
+void writeProfileReport(std::ostream &os);
+
+#ifdef GA_PROFILE
+
+namespace profiler_detail {
+
+inline uint64_t readTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+struct Scope;
+
+// Counters of one thread; only that thread writes them, reports read them concurrently
+struct alignas(64) ThreadProfile {
+    std::atomic<uint64_t> calls[static_cast<size_t>(ProfileZone::Count)] = {};
+    std::atomic<uint64_t> totalTicks[static_cast<size_t>(ProfileZone::Count)] = {};
+    std::atomic<uint64_t> selfTicks[static_cast<size_t>(ProfileZone::Count)] = {};
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> allocatedBytes{0};
+    Scope *current = nullptr; // innermost open zone
+
+    static void add(std::atomic<uint64_t> &counter, uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+};
+
+// The calling thread's counters, or nullptr before its first zone
+inline ThreadProfile *&threadSlot() {
+    static thread_local ThreadProfile *slot = nullptr;
+    return slot;
+}
+
+ThreadProfile *registerThread();
+
+inline ThreadProfile &threadProfile() {
+    ThreadProfile *&slot = threadSlot();
+    if (!slot) slot = registerThread();
+    return *slot;
+}
+
+struct Scope {
+    ProfileZone zone;
+    ThreadProfile &thread;
+    Scope *parent;
+    uint64_t children = 0;
+    uint64_t start;
+
+    explicit Scope(ProfileZone zone)
+            : zone(zone), thread(threadProfile()), parent(thread.current), start(readTicks()) {
+        thread.current = this;
+    }
+
+    ~Scope() {
+        uint64_t elapsed = readTicks() - start;
+        size_t z = static_cast<size_t>(zone);
+        ThreadProfile::add(thread.calls[z], 1);
+        ThreadProfile::add(thread.totalTicks[z], elapsed);
+        ThreadProfile::add(thread.selfTicks[z], elapsed - children);
+        thread.current = parent;
+        if (parent) parent->children += elapsed;
+    }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+};
+
+#if defined(GA_PROFILE_ITT)
+__itt_domain *ittDomain();
+__itt_string_handle *ittName(ProfileZone zone);
+
+struct IttScope {
+    explicit IttScope(ProfileZone zone) { __itt_task_begin(ittDomain(), __itt_null, __itt_null, ittName(zone)); }
+    ~IttScope() { __itt_task_end(ittDomain()); }
+};
+#endif
+
+} // namespace profiler_detail
+
+#define GA_PROFILE_CONCAT_(a, b) a##b
+#define GA_PROFILE_CONCAT(a, b) GA_PROFILE_CONCAT_(a, b)
+
+#if defined(GA_PROFILE_TRACY)
+#define GA_PROFILE_MARKER(zone) ZoneScopedN(#zone)
+#elif defined(GA_PROFILE_ITT)
+#define GA_PROFILE_MARKER(zone) \
+    ::profiler_detail::IttScope GA_PROFILE_CONCAT(gaIttScope, __LINE__)(ProfileZone::zone)
+#else
+#define GA_PROFILE_MARKER(zone)
+#endif
+
+// Time the rest of the enclosing block as the given ProfileZone (e.g. GA_PROFILE_ZONE(Crossover))
+#define GA_PROFILE_ZONE(zone) \
+    ::profiler_detail::Scope GA_PROFILE_CONCAT(gaProfileScope, __LINE__)(ProfileZone::zone); \
+    GA_PROFILE_MARKER(zone)
+
+#else
+
+#define GA_PROFILE_ZONE(zone) static_cast<void>(0)
+
+#endif
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+// xoshiro256** pseudo-random generator (Blackman & Vigna).
+//
+// Every GA operator draws from an Rng passed in by the caller instead of the global rand(),
+// so parallel workers never share generator state. Independent streams are obtained either
+// by deriving a generator from (seed, stream, substream) counters with forStream, which
+// gives the same numbers no matter which thread ends up doing the work, or by jump(), which
+// advances a generator by 2^128 draws.
+//
+// Satisfies UniformRandomBitGenerator, so it can be handed to std::shuffle and friends.
+class Rng {
+public:
+    using result_type = uint64_t;
+
+    explicit Rng(uint64_t seed = 0) { reseed(seed); }
+
+    // Generator for the given counters; distinct counter tuples give statistically independent streams
+    static Rng forStream(uint64_t seed, uint64_t stream, uint64_t substream = 0) {
+        uint64_t mixed = seed;
+        mixed = splitMix(mixed) ^ stream;
+        mixed = splitMix(mixed) ^ substream;
+        return Rng(mixed);
+    }
+
+    void reseed(uint64_t seed) {
+        // SplitMix64 expansion of the seed, as recommended for xoshiro
+        for (uint64_t &word: s) {
+            word = splitMix(seed);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        const uint64_t result = rotl(s[1] * 5, 7) * 9;
+        const uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // Uniform integer in [0, bound) by Lemire's multiply-shift on the high 32 bits
+    // (bias at most bound / 2^32)
+    uint32_t below(uint32_t bound) {
+        return static_cast<uint32_t>(((*this)() >> 32) * bound >> 32);
+    }
+
+    // Uniform double in [0, 1)
+    double uniform() {
+        return static_cast<double>((*this)() >> 11) * 0x1.0p-53;
+    }
+
+    // True with probability p
+    bool chance(double p) {
+        return uniform() < p;
+    }
+
+    // Advance the generator by 2^128 draws
+    void jump() {
+        static const uint64_t JUMP[] = {0x180ec6d33cfd0aba, 0xd5a61266f0c9392c,
+                                        0xa9582618e03fc9aa, 0x39abdc4529b1661c};
+        std::array<uint64_t, 4> t{};
+        for (uint64_t mask: JUMP) {
+            for (int b = 0; b < 64; ++b) {
+                if (mask & (uint64_t(1) << b)) {
+                    for (int k = 0; k < 4; ++k) t[k] ^= s[k];
+                }
+                (*this)();
+            }
+        }
+        s = t;
+    }
+
+    const std::array<uint64_t, 4> &state() const { return s; }
+    void setState(const std::array<uint64_t, 4> &state) { s = state; }
+
+private:
+    std::array<uint64_t, 4> s{};
+
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    static uint64_t splitMix(uint64_t &x) {
+        uint64_t z = (x += 0x9e3779b97f4a7c15);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        return z ^ (z >> 31);
+    }
+};
@@ -0,0 +1,136 @@
+#include "common/Reporter.h"
+
+#include <chrono>
+#include <climits>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+// Records in flight between the GA and the writer; the GA only blocks if the writer falls this far behind
+static const size_t QUEUE_CAPACITY = 4096;
+
+ReportOptions reportOptionsFromConfig(const Config &config) {
+    ReportOptions options;
+    options.path = config.getString("report-file", "");
+    std::string format = config.getString("report-format", "text");
+    if (format == "text") options.format = ReportFormat::Text;
+    else if (format == "csv") options.format = ReportFormat::Csv;
+    else if (format == "binary") options.format = ReportFormat::Binary;
+    else throw std::invalid_argument("--report-format must be text, csv or binary");
+    std::string value = config.getString("report", "summary");
+    if (value == "none") {
+        options.verbosity = Verbosity::None;
+    } else if (value == "summary") {
+        options.verbosity = Verbosity::Summary;
+    } else if (value == "full") {
+        options.verbosity = Verbosity::Full;
+    } else if (value.rfind("every:", 0) == 0) {
+        options.verbosity = Verbosity::EveryN;
+        long every = parseIntOption("report", value.substr(6));
+        if (every < 1 || every > INT_MAX) throw std::invalid_argument("--report every:N needs 1 <= N <= INT_MAX");
+        options.every = static_cast<int>(every);
+    } else {
+        throw std::invalid_argument("--report must be none, summary, every:N or full");
+    }
+    return options;
+}
+
+Reporter::Reporter(ReportOptions options) : options(std::move(options)), out(&std::cout), queue(QUEUE_CAPACITY) {
+    bool perGeneration = this->options.verbosity == Verbosity::EveryN || this->options.verbosity == Verbosity::Full;
+    if (!perGeneration) {
+        return;
+    }
+    if (!this->options.path.empty()) {
+        auto mode = this->options.format == ReportFormat::Binary ? std::ios::out | std::ios::binary : std::ios::out;
+        file.open(this->options.path, mode);
+        if (!file) throw std::runtime_error("cannot open report file " + this->options.path);
+        out = &file;
+    }
+    if (this->options.format == ReportFormat::Csv) {
+        *out << "generation,seconds,best,mean,diversity\n";
+    } else if (this->options.format == ReportFormat::Binary) {
+        out->write("GASTATS1", 8);
+    }
+    writer = std::thread(&Reporter::run, this);
+}
+
+Reporter::~Reporter() {
+    if (writer.joinable()) {
+        done.store(true, std::memory_order_release);
+        writer.join();
+    }
+    out->flush();
+}
+
+bool Reporter::wants(int64_t generation) const {
+    switch (options.verbosity) {
+        case Verbosity::None:
+        case Verbosity::Summary:
+            return false;
+        case Verbosity::EveryN:
+            return generation % options.every == 0;
+        case Verbosity::Full:
+            return true;
+    }
+    return false;
+}
+
+void Reporter::record(const GenerationStats &stats) {
+    Message message;
+    message.stats = stats;
+    push(std::move(message));
+}
+
+void Reporter::dump(std::string text) {
+    Message message;
+    message.text = std::make_unique<std::string>(std::move(text));
+    push(std::move(message));
+}
+
+void Reporter::push(Message message) {
+    if (!writer.joinable()) {
+        return;
+    }
+    while (!queue.tryPush(std::move(message))) {
+        std::this_thread::yield();
+    }
+}
+
+void Reporter::write(const Message &message) {
+    if (message.text) {
+        *out << *message.text;
+        return;
+    }
+    const GenerationStats &s = message.stats;
+    switch (options.format) {
+        case ReportFormat::Text:
+            *out << "Generation " << s.generation << ": best " << s.best << ", mean " << s.mean << ", diversity "
+                 << s.diversity << " (" << s.seconds * 1000.0 << " ms)\n";
+            break;
+        case ReportFormat::Csv:
+            *out << s.generation << ',' << s.seconds << ',' << s.best << ',' << s.mean << ',' << s.diversity << '\n';
+            break;
+        case ReportFormat::Binary:
+            out->write(reinterpret_cast<const char *>(&s), sizeof(s));
+            break;
+    }
+}
+
+void Reporter::run() {
+    Message message;
+    while (true) {
+        // Read the flag before draining so nothing pushed before it was set can be missed
+        bool finished = done.load(std::memory_order_acquire);
+        bool any = false;
+        while (queue.tryPop(message)) {
+            write(message);
+            any = true;
+        }
+        if (finished) {
+            break;
+        }
+        if (!any) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+
+#include "common/Config.h"
+#include "common/SpscQueue.h"
+
+// Per-generation statistics of a GA run
+struct GenerationStats {
+    int64_t generation;
+    double seconds;   // since the start of the run
+    double best;      // best fitness (OneMax) or shortest tour length (TSP)
+    double mean;
+    double diversity; // 0 = every individual identical, 1 = maximally diverse
+};
+
+enum class Verbosity {
+    None,    // nothing per generation
+    Summary, // only the final result
+    EveryN,  // statistics every `every` generations
+    Full     // statistics and a dump of the population every generation
+};
+
+enum class ReportFormat {
+    Text,  // "Generation N: best ..., mean ..., diversity ..."
+    Csv,   // generation,seconds,best,mean,diversity
+    Binary // "GASTATS1" followed by raw GenerationStats records
+};
+
+struct ReportOptions {
+    Verbosity verbosity = Verbosity::Summary;
+    int every = 100;
+    ReportFormat format = ReportFormat::Text;
+    std::string path; // empty = standard output
+};
+
+// Reporting settings of a driver: "report" (none|summary|every:N|full), "report-format" (text|csv|binary)
+// and "report-file" (path). Throws std::invalid_argument on bad values.
+ReportOptions reportOptionsFromConfig(const Config &config);
+
+// Generation reporting that keeps I/O off the GA's critical path: the GA thread only pushes
+// fixed-size records (and, in Full mode, preformatted population dumps) into a lock-free queue,
+// and a background thread formats and writes them with buffered output. Destroying the reporter
+// drains the queue and joins the writer.
+class Reporter {
+public:
+    explicit Reporter(ReportOptions options);
+    ~Reporter();
+
+    Reporter(const Reporter &) = delete;
+    Reporter &operator=(const Reporter &) = delete;
+
+    // Whether statistics of this generation will be written; lets callers skip computing them
+    bool wants(int64_t generation) const;
+    bool wantsDump() const { return options.verbosity == Verbosity::Full && options.format == ReportFormat::Text; }
+
+    void record(const GenerationStats &stats);
+
+    // Population dump (Full verbosity, text format only)
+    void dump(std::string text);
+
+private:
+    struct Message {
+        GenerationStats stats{};
+        std::unique_ptr<std::string> text; // dump instead of statistics when set
+    };
+
+    ReportOptions options;
+    std::ofstream file;
+    std::ostream *out;
+    SpscQueue<Message> queue;
+    std::atomic<bool> done{false};
+    std::thread writer;
+
+    void push(Message message);
+    void write(const Message &message);
+    void run();
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Bounded lock-free single-producer/single-consumer queue. The producer and consumer only
+// synchronize through the head/tail counters; slots are preallocated at construction.
+template<typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) : slots(capacity) {}
+
+    // Producer side; returns false if the queue is full, in which case `value` is left untouched
+    // (moved from only when it was queued), so the caller can retry with it
+    bool tryPush(T &&value) { return emplace(std::move(value)); }
+    bool tryPush(const T &value) { return emplace(value); }
+
+    // Consumer side; returns false if the queue is empty
+    bool tryPop(T &value) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(slots[h % slots.size()]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::vector<T> slots;
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+
+    template<typename U>
+    bool emplace(U &&value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == slots.size()) {
+            return false;
+        }
+        slots[t % slots.size()] = std::forward<U>(value);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+};
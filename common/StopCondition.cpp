@@ -0,0 +1,73 @@
+#include "common/StopCondition.h"
+
+#include <limits>
+#include <stdexcept>
+
+const char *stopReasonName(StopReason reason) {
+    switch (reason) {
+        case StopReason::None:
+            return "generation limit";
+        case StopReason::Target:
+            return "target reached";
+        case StopReason::Stagnation:
+            return "stagnation";
+        case StopReason::TimeLimit:
+            return "time limit";
+        case StopReason::Evaluations:
+            return "evaluation budget";
+    }
+    return "unknown";
+}
+
+StopCriteria stopCriteriaFromConfig(const Config &config) {
+    StopCriteria criteria;
+    if (config.has("target")) criteria.target = config.getDouble("target", 0.0);
+    criteria.stagnation = static_cast<int>(config.getInt("stagnation", criteria.stagnation));
+    criteria.timeLimit = config.getDouble("time-limit", criteria.timeLimit);
+    criteria.maxEvaluations = config.getInt("max-evaluations", static_cast<long>(criteria.maxEvaluations));
+    if (criteria.stagnation < 0 || criteria.timeLimit < 0.0 || criteria.maxEvaluations < 0) {
+        throw std::invalid_argument("--stagnation, --time-limit and --max-evaluations must not be negative");
+    }
+    return criteria;
+}
+
+StopCondition::StopCondition(const StopCriteria &criteria, bool maximize)
+        : criteria(criteria), maximize(maximize), start(std::chrono::steady_clock::now()),
+          bestSeen(maximize ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity()) {}
+
+void StopCondition::requestStop(StopReason reason) {
+    StopReason expected = StopReason::None;
+    why.compare_exchange_strong(expected, reason, std::memory_order_relaxed);
+}
+
+bool StopCondition::update(int generation, double best) {
+    if (stopped()) {
+        return true;
+    }
+    // Lower (or raise) the shared best; only the caller that improves it moves the stagnation mark
+    double seen = bestSeen.load(std::memory_order_relaxed);
+    bool improved = false;
+    while (better(best, seen)) {
+        if (bestSeen.compare_exchange_weak(seen, best, std::memory_order_relaxed)) {
+            improved = true;
+            break;
+        }
+    }
+    if (improved) {
+        improvedAt.store(generation, std::memory_order_relaxed);
+    }
+
+    if (criteria.target && !better(*criteria.target, best)) {
+        requestStop(StopReason::Target);
+    } else if (criteria.stagnation > 0 &&
+               generation - improvedAt.load(std::memory_order_relaxed) >= criteria.stagnation) {
+        requestStop(StopReason::Stagnation);
+    } else if (criteria.maxEvaluations > 0 &&
+               evaluations.load(std::memory_order_relaxed) >= criteria.maxEvaluations) {
+        requestStop(StopReason::Evaluations);
+    } else if (criteria.timeLimit > 0.0 &&
+               std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() >= criteria.timeLimit) {
+        requestStop(StopReason::TimeLimit);
+    }
+    return stopped();
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+#include "common/Config.h"
+
+// When a run may end before its maximum number of generations. Zero disables a limit.
+struct StopCriteria {
+    std::optional<double> target; // stop once the best objective value reaches this
+    int stagnation = 0;           // stop after this many generations without improvement of the best
+    double timeLimit = 0.0;       // wall-clock seconds
+    int64_t maxEvaluations = 0;   // fitness evaluations (individuals created)
+};
+
+enum class StopReason {
+    None, // still running, or ran all its generations
+    Target,
+    Stagnation,
+    TimeLimit,
+    Evaluations
+};
+
+const char *stopReasonName(StopReason reason);
+
+// Stopping settings of a driver: "target", "stagnation" (generations), "time-limit" (seconds) and
+// "max-evaluations". Throws std::invalid_argument on bad values.
+StopCriteria stopCriteriaFromConfig(const Config &config);
+
+// Checks a run against its StopCriteria. All state is atomic and the first reason to fire is
+// latched, so the threads of a parallel engine (e.g. every island of the island model) can report
+// their progress and poll the outcome concurrently, without locks or an extra barrier: a relaxed
+// load of the flag per generation is all it costs them.
+class StopCondition {
+public:
+    // Starts the wall clock. With `maximize` a larger objective value is better (OneMax fitness),
+    // otherwise a smaller one (tour length).
+    explicit StopCondition(const StopCriteria &criteria, bool maximize = false);
+
+    StopCondition(const StopCondition &) = delete;
+    StopCondition &operator=(const StopCondition &) = delete;
+
+    void addEvaluations(int64_t count) { evaluations.fetch_add(count, std::memory_order_relaxed); }
+    int64_t evaluationCount() const { return evaluations.load(std::memory_order_relaxed); }
+
+    // Report the best objective value after a generation (0 = the initial population) and check
+    // every criterion; returns true once the run should stop, for whatever reason and whoever found it
+    bool update(int generation, double best);
+
+    bool stopped() const { return why.load(std::memory_order_relaxed) != StopReason::None; }
+    StopReason reason() const { return why.load(std::memory_order_relaxed); }
+
+    // Stop for the given reason unless a reason has already been latched
+    void requestStop(StopReason reason);
+
+private:
+    StopCriteria criteria;
+    bool maximize;
+    std::chrono::steady_clock::time_point start;
+    std::atomic<int64_t> evaluations{0};
+    std::atomic<double> bestSeen;
+    std::atomic<int> improvedAt{0};
+    std::atomic<StopReason> why{StopReason::None};
+
+    bool better(double a, double b) const { return maximize ? a > b : a < b; }
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+// Bounded Chase-Lev work-stealing deque (in the C11 formulation of Lê, Pop, Cohen and Zappa Nardelli).
+// The owning thread pushes and pops at the bottom, like a stack, without any read-modify-write
+// unless it races a thief for the last item; other threads steal the oldest item from the top with
+// a single CAS. Items must fit a lock-free atomic, so small task descriptors are stored by value.
+template<typename T>
+class WorkStealingDeque {
+    static_assert(std::is_trivially_copyable<T>::value, "deque items are copied through std::atomic");
+    static_assert(std::atomic<T>::is_always_lock_free, "deque items must fit a lock-free atomic");
+
+public:
+    // Room for at least `capacity` items (rounded up to a power of two)
+    explicit WorkStealingDeque(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) size *= 2;
+        mask = size - 1;
+        items = std::make_unique<std::atomic<T>[]>(size);
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+    // Owner side; returns false if the deque is full
+    bool tryPush(T item) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        if (b - top.load(std::memory_order_acquire) > static_cast<int64_t>(mask)) {
+            return false;
+        }
+        items[b & mask].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Owner side: the most recently pushed item; returns false if the deque is empty
+    bool tryPop(T &item) {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        item = items[b & mask].load(std::memory_order_relaxed);
+        if (t == b) {
+            // Last item: whoever moves top first, this thread or a thief, gets it
+            bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // Any thread: the oldest item; returns false if the deque is empty or another thread got there first
+    bool trySteal(T &item) {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return false;
+        }
+        item = items[t & mask].load(std::memory_order_relaxed);
+        return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    // Owner side; exact for the owner apart from concurrent steals, which only make it emptier
+    bool empty() const {
+        return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+    }
+
+private:
+    size_t mask;
+    std::unique_ptr<std::atomic<T>[]> items;
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Binary heap over the slots of a population keyed by their cached scores, with the worst slot
+// on top. Replace-worst insertion only has to overwrite the top key and sift it down, so each
+// child costs O(log n) instead of a scan of the whole population.
+class WorstHeap {
+public:
+    // Heap over slots 0..n-1, slot i scoring score(i). With `maximize` a larger score is better
+    // (fitness), otherwise a smaller one (tour length).
+    template<typename Score>
+    void build(size_t n, Score score, bool maximize) {
+        this->maximize = maximize;
+        entries.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            entries[i] = {static_cast<double>(score(i)), i};
+        }
+        for (size_t i = n / 2; i-- > 0;) {
+            siftDown(i);
+        }
+    }
+
+    // Heap with the slots in the given array order (as returned by slots()), e.g. from a checkpoint,
+    // so that ties between equal scores keep being broken the same way. Throws std::invalid_argument
+    // unless `order` is a permutation of 0..n-1 that satisfies the heap property for these scores.
+    template<typename Score>
+    void restore(const std::vector<size_t> &order, Score score, bool maximize) {
+        this->maximize = maximize;
+        entries.resize(order.size());
+        std::vector<bool> seen(order.size(), false);
+        for (size_t i = 0; i < order.size(); ++i) {
+            if (order[i] >= order.size() || seen[order[i]]) {
+                throw std::invalid_argument("heap slots are not a permutation of the population");
+            }
+            seen[order[i]] = true;
+            entries[i] = {static_cast<double>(score(order[i])), order[i]};
+            if (i > 0 && worse(entries[i].first, entries[(i - 1) / 2].first)) {
+                throw std::invalid_argument("heap slots are not in heap order");
+            }
+        }
+    }
+
+    // Slots in the order of the heap array
+    std::vector<size_t> slots() const {
+        std::vector<size_t> order(entries.size());
+        for (size_t i = 0; i < entries.size(); ++i) {
+            order[i] = entries[i].second;
+        }
+        return order;
+    }
+
+    bool empty() const { return entries.empty(); }
+    size_t worst() const { return entries[0].second; }
+    double worstScore() const { return entries[0].first; }
+
+    // Whether an individual with this score would displace the worst one
+    bool improves(double score) const { return worse(entries[0].first, score); }
+
+    // The worst slot now holds an individual with the given score
+    void replaceWorst(double score) {
+        entries[0].first = score;
+        siftDown(0);
+    }
+
+private:
+    std::vector<std::pair<double, size_t>> entries; // (score, slot)
+    bool maximize = false;
+
+    bool worse(double a, double b) const { return maximize ? a < b : a > b; }
+
+    void siftDown(size_t i) {
+        size_t n = entries.size();
+        while (true) {
+            size_t top = i, left = 2 * i + 1, right = left + 1;
+            if (left < n && worse(entries[left].first, entries[top].first)) top = left;
+            if (right < n && worse(entries[right].first, entries[top].first)) top = right;
+            if (top == i) return;
+            std::swap(entries[i], entries[top]);
+            i = top;
+        }
+    }
+};
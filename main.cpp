@@ -1,119 +1,109 @@
 #include <iostream>
-#include <vector>
-#include <cstdlib>
 #include <ctime>
-#include <algorithm>
-//#include <omp.h>
 #include <chrono>
+#include <exception>
+#include <sstream>
+#include <string>
 
-using namespace std;
-
-const int POPULATION_SIZE = 100;
-const int GENOME_LENGTH = 10;
-const int MAX_GENERATIONS = 1000;
-const double MUTATION_RATE = 0.1;
-const double CROSSOVER_RATE = 0.6;
-
-class Genome {
-public:
-    vector<bool> genes;
+#include <omp.h>
 
-    Genome() {
-        for (int i = 0; i < GENOME_LENGTH; ++i) {
-            genes.push_back(rand() % 2);
-        }
-    }
-
-    double getFitness() const {
-        double fitness = 0;
-        for (int i = 0; i < GENOME_LENGTH; ++i) {
-            if (genes[i]) {
-                fitness += 1;
-            }
-        }
-        return fitness;
-    }
+#include "common/Config.h"
+#include "common/Profiler.h"
+#include "common/Reporter.h"
+#include "common/StopCondition.h"
+#include "onemax/BitKernels.h"
+#include "onemax/Population.h"
 
-    void mutate() {
-        for (int i = 0; i < GENOME_LENGTH; ++i) {
-            if ((double) rand() / RAND_MAX < MUTATION_RATE) {
-                genes[i] = !genes[i];
-            }
-        }
-    }
+using namespace std;
 
-    friend Genome crossover(const Genome& a, const Genome& b) {
-        Genome child;
-        for (int i = 0; i < GENOME_LENGTH; ++i) {
-            if ((double) rand() / RAND_MAX < CROSSOVER_RATE) {
-                child.genes.push_back(a.genes[i]);
-            } else {
-                child.genes.push_back(b.genes[i]);
-            }
+// Usage: onemax [--population N] [--genome-length N] [--generations N] [--mutation-rate P]
+//               [--crossover-rate P] [--elites N] [--replacement generational|steady] [--seed N]
+//               [--threads N] [--parallel true|false] [--config FILE]
+//               [--target FITNESS] [--stagnation N] [--time-limit SECONDS] [--max-evaluations N]
+//               [--report none|summary|every:N|full] [--report-format text|csv|binary] [--report-file PATH]
+//               [--profile-every N]
+// Defaults are those of OneMaxParameters, 1000 generations and a time-based seed. The run ends early
+// once a genome reaches the target fitness, by default the genome length (all genes set).
+int main(int argc, char **argv) {
+
+    OneMaxParameters params;
+    int maxGenerations = 1000;
+    ReportOptions reportOptions;
+    int profileEvery = 0;
+    StopCriteria stopCriteria;
+    try {
+        Config config = Config::fromCommandLine(argc, argv);
+        if (!config.positional().empty()) {
+            throw invalid_argument("unknown argument " + config.positional().front());
         }
-        return child;
-    }
-};
-
-class Population {
-public:
-    vector<Genome> genomes;
-
-    Population() {
-        for (int i = 0; i < POPULATION_SIZE; ++i) {
-            genomes.push_back(Genome());
+        params.populationSize = static_cast<int>(config.getInt("population", params.populationSize));
+        long genomeLength = config.getInt("genome-length", static_cast<long>(params.genomeLength));
+        params.mutationRate = config.getDouble("mutation-rate", params.mutationRate);
+        params.crossoverRate = config.getDouble("crossover-rate", params.crossoverRate);
+        params.seed = config.getUint64("seed", static_cast<uint64_t>(time(nullptr)));
+        params.parallel = config.getBool("parallel", params.parallel);
+        params.elites = static_cast<int>(config.getInt("elites", params.elites));
+        string replacement = config.getString("replacement", "generational");
+        if (replacement != "generational" && replacement != "steady") {
+            throw invalid_argument("--replacement must be generational or steady");
         }
-    }
-
-    void sort() {
-        std::sort(genomes.begin(), genomes.end(), [](const Genome& a, const Genome& b) {
-            return a.getFitness() > b.getFitness();
-        });
-    }
-
-    void evolve() {
-        sort();
-
-        vector<Genome> newGenomes;
-        for (int i = 0; i < POPULATION_SIZE; ++i) {
-            int parentA = rand() % (POPULATION_SIZE / 2);
-            int parentB = rand() % (POPULATION_SIZE / 2);
-            newGenomes.push_back(crossover(genomes[parentA], genomes[parentB]));
-            newGenomes.back().mutate();
+        params.steadyState = replacement == "steady";
+        maxGenerations = static_cast<int>(config.getInt("generations", maxGenerations));
+        if (params.populationSize < 1 || genomeLength < 1 || maxGenerations < 0) {
+            throw invalid_argument("--population and --genome-length must be at least 1");
         }
-        genomes = newGenomes;
-    }
-
-    double getBestFitness() const {
-        return genomes[0].getFitness();
-    }
-
-    friend ostream& operator<<(ostream& os, const Population& p) {
-        for (int i = 0; i < POPULATION_SIZE; ++i) {
-            for (int j = 0; j < GENOME_LENGTH; ++j) {
-                os << p.genomes[i].genes[j];
-            }
-            os << " (" << p.genomes[i].getFitness() << ")\n";
+        params.genomeLength = static_cast<size_t>(genomeLength);
+        if (config.has("threads")) {
+            long threads = config.getInt("threads", 1);
+            if (threads < 1) throw invalid_argument("--threads must be at least 1");
+            omp_set_num_threads(static_cast<int>(threads));
         }
-        return os;
+        reportOptions = reportOptionsFromConfig(config);
+        profileEvery = profileIntervalFromConfig(config);
+        stopCriteria = stopCriteriaFromConfig(config);
+        if (!stopCriteria.target) stopCriteria.target = static_cast<double>(params.genomeLength);
+        config.checkUnused();
+    } catch (const exception &e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
     }
-};
-
-int main() {
 
     // Starting the timer
     auto start = std::chrono::high_resolution_clock::now();
 
-    srand(time(nullptr));
-
-    Population population;
-
-    for (int i = 0; i < MAX_GENERATIONS; ++i) {
-        population.evolve();
-        cout << "Generation " << i + 1 << ":\n" << population << endl;
+    Population population(params);
+    StopCondition stop(stopCriteria, true);
+    stop.addEvaluations(params.populationSize);
+    int generations = 0;
+    {
+        // Generation reports are written by the reporter's background thread
+        Reporter reporter(reportOptions);
+
+        bool stopped = stop.update(0, double(population.getBestFitness()));
+        for (int i = 0; i < maxGenerations && !stopped; ++i) {
+            population.evolve(i + 1);
+            generations = i + 1;
+            if (reporter.wants(i + 1)) {
+                chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - start;
+                reporter.record({i + 1, elapsed.count(), double(population.getBestFitness()),
+                                 population.getMeanFitness(), population.getDiversity()});
+            }
+            if (reporter.wantsDump()) {
+                ostringstream dump;
+                dump << "Generation " << i + 1 << ":\n" << population << '\n';
+                reporter.dump(dump.str());
+            }
+            stop.addEvaluations(params.populationSize);
+            stopped = stop.update(i + 1, double(population.getBestFitness()));
+            if (profileEvery > 0 && (i + 1) % profileEvery == 0) {
+                cerr << "After generation " << i + 1 << ": ";
+                writeProfileReport(cerr);
+            }
+        }
     }
 
     cout << "Best fitness: " << population.getBestFitness() << endl;
+    cout << "Generations: " << generations << " (" << stopReasonName(stop.reason()) << ")" << endl;
 
     // Ending the timer
     auto end = std::chrono::high_resolution_clock::now();
@@ -122,7 +112,8 @@ int main() {
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
 
     // Print the elapsed time
-    cout << "Execution time: " << duration << " ms" << endl;
+    cout << "Execution time: " << duration << " ms (" << bitKernelsIsa() << " kernels)" << endl;
+    writeProfileReport(cout);
 
     return 0;
 }
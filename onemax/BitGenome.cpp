@@ -0,0 +1,121 @@
+#include "onemax/BitGenome.h"
+
+#include <cmath>
+
+#include "onemax/BitKernels.h"
+
+// Below this mutation rate flips are placed by geometric skips (cost proportional to the number of
+// flips); above it a Bernoulli bitmask is built a word at a time and xor-ed in with the SIMD kernel
+static const double SKIP_MUTATION_RATE = 1.0 / 64;
+
+// Probabilities are quantized to this many bits when building Bernoulli masks
+static const int MASK_PRECISION = 8;
+
+// Scratch space for masks, reused across calls on the same thread
+static std::vector<uint64_t> &maskScratch(size_t n) {
+    static thread_local std::vector<uint64_t> scratch;
+    if (scratch.size() < n) scratch.resize(n);
+    return scratch;
+}
+
+// Fill mask[0..n) with bits that are set independently with probability ~p (p quantized to
+// MASK_PRECISION bits). Processing the bits of p from the least significant one, each step
+// either ors (bit set) or ands (bit clear) a fresh uniform word, which halves-and-shifts the
+// probability exactly like reading the binary fraction of p.
+static void bernoulliMask(uint64_t *mask, size_t n, double p, Rng &rng) {
+    auto q = static_cast<unsigned>(std::lround(p * (1u << MASK_PRECISION)));
+    if (q == 0 || q >= (1u << MASK_PRECISION)) {
+        uint64_t fill = q == 0 ? 0 : ~uint64_t(0);
+        for (size_t i = 0; i < n; ++i) mask[i] = fill;
+        return;
+    }
+    // Trailing zero bits of q contribute nothing but an and with a fresh word; skip them
+    int lowest = __builtin_ctz(q);
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t m = rng();
+        for (int bit = lowest + 1; bit < MASK_PRECISION; ++bit) {
+            m = (q >> bit) & 1 ? (m | rng()) : (m & rng());
+        }
+        mask[i] = m;
+    }
+}
+
+BitGenome::BitGenome(size_t length) : words((length + 63) / 64, 0), length(length) {}
+
+BitGenome BitGenome::random(size_t length, Rng &rng) {
+    BitGenome genome(length);
+    for (uint64_t &word: genome.words) {
+        word = rng();
+    }
+    genome.clearTail();
+    return genome;
+}
+
+size_t BitGenome::getFitness() const {
+    switch (words.size()) {
+        case 1:
+            return popcountFixed<1>(words.data());
+        case 2:
+            return popcountFixed<2>(words.data());
+        case 4:
+            return popcountFixed<4>(words.data());
+        default:
+            return popcountWords(words.data(), words.size());
+    }
+}
+
+void BitGenome::mutate(double mutationRate, Rng &rng) {
+    if (mutationRate <= 0.0 || length == 0) {
+        return;
+    }
+    if (mutationRate < SKIP_MUTATION_RATE) {
+        // Distance to the next flipped gene is geometrically distributed
+        double logKeep = std::log1p(-mutationRate);
+        for (size_t i = static_cast<size_t>(std::log(1.0 - rng.uniform()) / logKeep); i < length;
+             i += 1 + static_cast<size_t>(std::log(1.0 - rng.uniform()) / logKeep)) {
+            flip(i);
+        }
+        return;
+    }
+    std::vector<uint64_t> &mask = maskScratch(words.size());
+    bernoulliMask(mask.data(), words.size(), mutationRate, rng);
+    switch (words.size()) {
+        case 1:
+            xorFixed<1>(words.data(), mask.data());
+            break;
+        case 2:
+            xorFixed<2>(words.data(), mask.data());
+            break;
+        case 4:
+            xorFixed<4>(words.data(), mask.data());
+            break;
+        default:
+            xorWords(words.data(), mask.data(), words.size());
+    }
+    clearTail();
+}
+
+void BitGenome::clearTail() {
+    if (length % 64 != 0) {
+        words.back() &= (uint64_t(1) << (length % 64)) - 1;
+    }
+}
+
+void crossover(const BitGenome &a, const BitGenome &b, BitGenome &child, double crossoverRate, Rng &rng) {
+    size_t n = a.words.size();
+    std::vector<uint64_t> &mask = maskScratch(n);
+    bernoulliMask(mask.data(), n, crossoverRate, rng);
+    switch (n) {
+        case 1:
+            selectFixed<1>(child.words.data(), a.words.data(), b.words.data(), mask.data());
+            break;
+        case 2:
+            selectFixed<2>(child.words.data(), a.words.data(), b.words.data(), mask.data());
+            break;
+        case 4:
+            selectFixed<4>(child.words.data(), a.words.data(), b.words.data(), mask.data());
+            break;
+        default:
+            selectWords(child.words.data(), a.words.data(), b.words.data(), mask.data(), n);
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "common/Random.h"
+
+// Bit-packed binary genome: gene i is bit (i % 64) of words[i / 64]. Bits past the genome length
+// in the last word are always zero, so whole-word operations never see stray genes.
+class BitGenome {
+public:
+    std::vector<uint64_t> words;
+
+    BitGenome() = default;
+
+    // Genome of the given length with every gene cleared
+    explicit BitGenome(size_t length);
+
+    // Genome of the given length with uniformly random genes
+    static BitGenome random(size_t length, Rng &rng);
+
+    size_t size() const { return length; }
+
+    bool operator[](size_t i) const { return (words[i / 64] >> (i % 64)) & 1; }
+    void flip(size_t i) { words[i / 64] ^= uint64_t(1) << (i % 64); }
+
+    // OneMax fitness: the number of set genes
+    size_t getFitness() const;
+
+    // Flip every gene independently with the given probability
+    void mutate(double mutationRate, Rng &rng);
+
+    // Clear the bits past the genome length in the last word
+    void clearTail();
+
+private:
+    size_t length = 0;
+};
+
+// Uniform crossover: each gene of `child` comes from `a` with probability crossoverRate and from `b`
+// otherwise. `child` must already have the parents' length.
+void crossover(const BitGenome &a, const BitGenome &b, BitGenome &child, double crossoverRate, Rng &rng);
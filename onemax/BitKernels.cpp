@@ -0,0 +1,168 @@
+#include "onemax/BitKernels.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ONEMAX_X86_DISPATCH 1
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Scalar versions
+
+static size_t popcountScalar(const uint64_t *words, size_t n) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        count += static_cast<size_t>(__builtin_popcountll(words[i]));
+    }
+    return count;
+}
+
+static void selectScalar(uint64_t *dst, const uint64_t *a, const uint64_t *b, const uint64_t *mask, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = (a[i] & mask[i]) | (b[i] & ~mask[i]);
+    }
+}
+
+static void xorScalar(uint64_t *dst, const uint64_t *mask, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] ^= mask[i];
+    }
+}
+
+#ifdef ONEMAX_X86_DISPATCH
+
+// Same loop compiled with the hardware popcnt instruction
+__attribute__((target("popcnt")))
+static size_t popcountHardware(const uint64_t *words, size_t n) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        count += static_cast<size_t>(__builtin_popcountll(words[i]));
+    }
+    return count;
+}
+
+// Nibble-lookup popcount (Mula): pshufb counts the bits of every nibble, sad sums them per 64-bit lane
+__attribute__((target("avx2,popcnt")))
+static size_t popcountAvx2(const uint64_t *words, size_t n) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0f);
+    __m256i total = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(words + i));
+        __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low));
+        __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low));
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+    }
+    size_t count = static_cast<size_t>(_mm256_extract_epi64(total, 0) + _mm256_extract_epi64(total, 1) +
+                                       _mm256_extract_epi64(total, 2) + _mm256_extract_epi64(total, 3));
+    return count + popcountHardware(words + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static void selectAvx2(uint64_t *dst, const uint64_t *a, const uint64_t *b, const uint64_t *mask, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(mask + i));
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+        __m256i v = _mm256_or_si256(_mm256_and_si256(va, m), _mm256_andnot_si256(m, vb));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), v);
+    }
+    selectScalar(dst + i, a + i, b + i, mask + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static void xorAvx2(uint64_t *dst, const uint64_t *mask, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+        __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(mask + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_xor_si256(d, m));
+    }
+    xorScalar(dst + i, mask + i, n - i);
+}
+
+static bool hasAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+    return supported;
+}
+
+static bool hasPopcnt() {
+    static const bool supported = __builtin_cpu_supports("popcnt");
+    return supported;
+}
+
+size_t popcountWords(const uint64_t *words, size_t n) {
+    if (hasAvx2()) return popcountAvx2(words, n);
+    if (hasPopcnt()) return popcountHardware(words, n);
+    return popcountScalar(words, n);
+}
+
+void selectWords(uint64_t *dst, const uint64_t *a, const uint64_t *b, const uint64_t *mask, size_t n) {
+    if (hasAvx2()) return selectAvx2(dst, a, b, mask, n);
+    selectScalar(dst, a, b, mask, n);
+}
+
+void xorWords(uint64_t *dst, const uint64_t *mask, size_t n) {
+    if (hasAvx2()) return xorAvx2(dst, mask, n);
+    xorScalar(dst, mask, n);
+}
+
+const char *bitKernelsIsa() {
+    return hasAvx2() ? "avx2" : "scalar";
+}
+
+#elif defined(__ARM_NEON)
+
+size_t popcountWords(const uint64_t *words, size_t n) {
+    uint64x2_t total = vdupq_n_u64(0);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        uint8x16_t bytes = vcntq_u8(vreinterpretq_u8_u64(vld1q_u64(words + i)));
+        total = vaddq_u64(total, vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(bytes))));
+    }
+    return static_cast<size_t>(vgetq_lane_u64(total, 0) + vgetq_lane_u64(total, 1)) +
+           popcountScalar(words + i, n - i);
+}
+
+void selectWords(uint64_t *dst, const uint64_t *a, const uint64_t *b, const uint64_t *mask, size_t n) {
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        vst1q_u64(dst + i, vbslq_u64(vld1q_u64(mask + i), vld1q_u64(a + i), vld1q_u64(b + i)));
+    }
+    selectScalar(dst + i, a + i, b + i, mask + i, n - i);
+}
+
+void xorWords(uint64_t *dst, const uint64_t *mask, size_t n) {
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        vst1q_u64(dst + i, veorq_u64(vld1q_u64(dst + i), vld1q_u64(mask + i)));
+    }
+    xorScalar(dst + i, mask + i, n - i);
+}
+
+const char *bitKernelsIsa() {
+    return "neon";
+}
+
+#else
+
+size_t popcountWords(const uint64_t *words, size_t n) {
+    return popcountScalar(words, n);
+}
+
+void selectWords(uint64_t *dst, const uint64_t *a, const uint64_t *b, const uint64_t *mask, size_t n) {
+    selectScalar(dst, a, b, mask, n);
+}
+
+void xorWords(uint64_t *dst, const uint64_t *mask, size_t n) {
+    xorScalar(dst, mask, n);
+}
+
+const char *bitKernelsIsa() {
+    return "scalar";
+}
+
+#endif
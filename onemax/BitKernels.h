@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Word-array kernels behind BitGenome. Each one has a scalar version and, where it pays off,
+// an AVX2 (x86, picked at runtime from the CPU's features) or NEON (ARM, picked at compile time)
+// version. All arrays hold n words and may alias only where noted.
+
+// Number of set bits
+size_t popcountWords(const uint64_t *words, size_t n);
+
+// dst = (a & mask) | (b & ~mask): bits from `a` where the mask is set, from `b` elsewhere
+void selectWords(uint64_t *dst, const uint64_t *a, const uint64_t *b, const uint64_t *mask, size_t n);
+
+// dst ^= mask (flip the bits set in the mask)
+void xorWords(uint64_t *dst, const uint64_t *mask, size_t n);
+
+// Fixed-size versions for genomes of a few words, where the loop and the runtime dispatch of the
+// kernels above cost more than the work itself. With the word count as a template parameter the
+// compiler unrolls them completely; BitGenome switches to them for its common short lengths.
+template<size_t N>
+inline size_t popcountFixed(const uint64_t *words) {
+    size_t count = 0;
+    for (size_t i = 0; i < N; ++i) count += static_cast<size_t>(__builtin_popcountll(words[i]));
+    return count;
+}
+
+template<size_t N>
+inline void selectFixed(uint64_t *dst, const uint64_t *a, const uint64_t *b, const uint64_t *mask) {
+    for (size_t i = 0; i < N; ++i) dst[i] = (a[i] & mask[i]) | (b[i] & ~mask[i]);
+}
+
+template<size_t N>
+inline void xorFixed(uint64_t *dst, const uint64_t *mask) {
+    for (size_t i = 0; i < N; ++i) dst[i] ^= mask[i];
+}
+
+// Name of the instruction set the kernels dispatch to on this machine ("avx2", "neon" or "scalar")
+const char *bitKernelsIsa();
@@ -0,0 +1,125 @@
+#include "onemax/Population.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "common/Profiler.h"
+
+// Random stream of the i-th genome of a generation, independent of the thread that builds it
+static Rng genomeRng(const OneMaxParameters &params, int generation, int i) {
+    return Rng::forStream(params.seed, static_cast<uint64_t>(generation), static_cast<uint64_t>(i));
+}
+
+Population::Population(const OneMaxParameters &params)
+        : genomes(params.populationSize), fitness(params.populationSize), params(params),
+          newFitness(params.populationSize), ranking(params.populationSize) {
+    GA_PROFILE_ZONE(Initialization);
+    #pragma omp parallel for if(params.parallel)
+    for (int i = 0; i < params.populationSize; ++i) {
+        Rng rng = genomeRng(params, 0, i);
+        genomes[i] = BitGenome::random(params.genomeLength, rng);
+        fitness[i] = genomes[i].getFitness();
+    }
+    for (int i = 0; i < params.populationSize; ++i) {
+        newGenomes.emplace_back(params.genomeLength);
+    }
+    if (params.steadyState) {
+        heap.build(fitness.size(), [&](size_t i) { return fitness[i]; }, true);
+    }
+}
+
+void Population::evolve(int generation) {
+    // Move the indices of the fitter half to the front
+    int half = std::max(1, params.populationSize / 2);
+    {
+        GA_PROFILE_ZONE(Selection);
+        std::iota(ranking.begin(), ranking.end(), 0);
+        std::nth_element(ranking.begin(), ranking.begin() + (half - 1), ranking.end(), [&](int a, int b) {
+            return fitness[a] > fitness[b];
+        });
+    }
+
+    // The fittest genomes are carried over into the first slots
+    int elites = params.steadyState ? 0 : std::min(params.elites, half);
+    if (elites > 0) {
+        std::nth_element(ranking.begin(), ranking.begin() + (elites - 1), ranking.begin() + half, [&](int a, int b) {
+            return fitness[a] > fitness[b];
+        });
+        GA_PROFILE_ZONE(Copy);
+        for (int e = 0; e < elites; ++e) {
+            newGenomes[e].words = genomes[ranking[e]].words;
+            newFitness[e] = fitness[ranking[e]];
+        }
+    }
+
+    // Children are written into the second buffer, which then becomes the population
+    #pragma omp parallel for if(params.parallel)
+    for (int i = elites; i < params.populationSize; ++i) {
+        Rng rng = genomeRng(params, generation, i);
+        int parentA = ranking[rng.below(half)];
+        int parentB = ranking[rng.below(half)];
+        {
+            GA_PROFILE_ZONE(Crossover);
+            crossover(genomes[parentA], genomes[parentB], newGenomes[i], params.crossoverRate, rng);
+        }
+        {
+            GA_PROFILE_ZONE(Mutation);
+            newGenomes[i].mutate(params.mutationRate, rng);
+        }
+        GA_PROFILE_ZONE(Evaluation);
+        newFitness[i] = newGenomes[i].getFitness();
+    }
+    if (params.steadyState) {
+        GA_PROFILE_ZONE(Replacement);
+        for (int i = 0; i < params.populationSize; ++i) {
+            if (heap.improves(static_cast<double>(newFitness[i]))) {
+                genomes[heap.worst()].words.swap(newGenomes[i].words);
+                fitness[heap.worst()] = newFitness[i];
+                heap.replaceWorst(static_cast<double>(newFitness[i]));
+            }
+        }
+        return;
+    }
+    genomes.swap(newGenomes);
+    fitness.swap(newFitness);
+}
+
+size_t Population::bestIndex() const {
+    return std::max_element(fitness.begin(), fitness.end()) - fitness.begin();
+}
+
+double Population::getMeanFitness() const {
+    return std::accumulate(fitness.begin(), fitness.end(), 0.0) / fitness.size();
+}
+
+double Population::getDiversity() const {
+    size_t length = params.genomeLength;
+    if (length == 0 || genomes.empty()) {
+        return 0.0;
+    }
+    double populationSize = static_cast<double>(genomes.size());
+    double total = 0.0;
+    std::vector<uint32_t> ones(64);
+    for (size_t w = 0; w < genomes[0].words.size(); ++w) {
+        std::fill(ones.begin(), ones.end(), 0);
+        for (const BitGenome &genome: genomes) {
+            for (uint64_t word = genome.words[w]; word != 0; word &= word - 1) {
+                ++ones[__builtin_ctzll(word)];
+            }
+        }
+        for (uint32_t c: ones) {
+            total += 4.0 * c * (populationSize - c) / (populationSize * populationSize);
+        }
+    }
+    return total / length;
+}
+
+std::ostream &operator<<(std::ostream &os, const Population &p) {
+    for (size_t i = 0; i < p.genomes.size(); ++i) {
+        for (size_t j = 0; j < p.genomes[i].size(); ++j) {
+            os << p.genomes[i][j];
+        }
+        os << " (" << p.fitness[i] << ")\n";
+    }
+    return os;
+}
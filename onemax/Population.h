@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "common/WorstHeap.h"
+#include "onemax/BitGenome.h"
+
+struct OneMaxParameters {
+    int populationSize = 100;
+    size_t genomeLength = 10;
+    double mutationRate = 0.1;
+    double crossoverRate = 0.6;
+    uint64_t seed = 0;
+    // Build and evaluate the children of a generation in an OpenMP parallel loop
+    bool parallel = true;
+    // Number of fittest genomes carried over unchanged into the next generation
+    int elites = 0;
+    // Instead of replacing the population, let every child replace the current least fit genome
+    // if it is fitter
+    bool steadyState = false;
+};
+
+// Population of the binary GA. Each genome's fitness is computed once, when the genome is created,
+// and cached in `fitness`; selection and reporting only read the cache.
+class Population {
+public:
+    std::vector<BitGenome> genomes;
+    std::vector<size_t> fitness;
+
+    explicit Population(const OneMaxParameters &params);
+
+    // Replace the population with the next generation (counted from 1). Parents are drawn uniformly
+    // from the fitter half, which nth_element separates in linear time instead of a full sort.
+    // Steady-state, the children displace the least fit genomes one by one instead, found through a
+    // heap over the cached fitness in O(log n) per child.
+    void evolve(int generation);
+
+    size_t bestIndex() const;
+    size_t getBestFitness() const { return fitness[bestIndex()]; }
+    double getMeanFitness() const;
+
+    // Mean per-gene heterozygosity 4 c (P - c) / P^2, where c of the P genomes carry the gene:
+    // 0 when all genomes are identical, 1 when every gene is split half and half
+    double getDiversity() const;
+
+    friend std::ostream &operator<<(std::ostream &os, const Population &p);
+
+private:
+    OneMaxParameters params;
+    std::vector<BitGenome> newGenomes;
+    std::vector<size_t> newFitness;
+    std::vector<int> ranking;
+    WorstHeap heap; // steady-state only
+};
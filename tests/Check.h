@@ -0,0 +1,38 @@
+#pragma once
+
+#include <atomic>
+#include <iostream>
+
+// Minimal assertions for the test executables: a failed CHECK reports its location and the test's
+// main() returns checkResult(), which is non-zero once anything failed. Safe to use from any thread.
+
+inline std::atomic<int> &checkFailures() {
+    static std::atomic<int> failures{0};
+    return failures;
+}
+
+inline void reportFailure(const char *file, int line, const char *what) {
+    std::cerr << file << ':' << line << ": " << what << std::endl;
+    ++checkFailures();
+}
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) reportFailure(__FILE__, __LINE__, "CHECK(" #condition ") failed"); \
+    } while (0)
+
+// `statement` must throw an `exception` (or a type derived from it)
+#define CHECK_THROWS(statement, exception) \
+    do { \
+        bool thrown = false; \
+        try { \
+            statement; \
+        } catch (const exception &) { \
+            thrown = true; \
+        } \
+        if (!thrown) reportFailure(__FILE__, __LINE__, #statement " did not throw " #exception); \
+    } while (0)
+
+inline int checkResult() {
+    return checkFailures() == 0 ? 0 : 1;
+}
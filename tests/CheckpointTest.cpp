@@ -0,0 +1,134 @@
+// Checkpoint files: save/load round trips (generational and steady state) and rejection of
+// truncated, corrupted and inconsistent files
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "common/Random.h"
+#include "common/WorstHeap.h"
+#include "tests/Check.h"
+#include "tsp/Checkpoint.h"
+
+namespace {
+
+std::string temporaryPath(const std::string &name) {
+    return "/tmp/ga_checkpoint_test_" + std::to_string(::getpid()) + "_" + name;
+}
+
+std::vector<unsigned char> readBytes(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+void writeBytes(const std::string &path, const std::vector<unsigned char> &bytes) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+Checkpoint randomCheckpoint(size_t size, size_t cities, bool steady) {
+    Checkpoint checkpoint;
+    checkpoint.seed = 42;
+    checkpoint.settings = 0x1234;
+    checkpoint.instance = 0x5678;
+    checkpoint.generation = 17;
+    checkpoint.population = Population(size, cities);
+    Rng rng(7);
+    for (size_t i = 0; i < size; ++i) {
+        RouteView route = checkpoint.population.route(i);
+        std::iota(route.order, route.order + cities, CityId(0));
+        std::shuffle(route.order, route.order + cities, rng);
+        route.rebuildPositions();
+        *route.length = 1000.0 + rng.uniform();
+    }
+    if (steady) {
+        WorstHeap heap;
+        heap.build(size, [&](size_t i) { return checkpoint.population.length(i); }, false);
+        checkpoint.heap = heap.slots();
+    }
+    return checkpoint;
+}
+
+void checkSame(const Checkpoint &a, const Checkpoint &b) {
+    CHECK(a.seed == b.seed && a.settings == b.settings && a.instance == b.instance);
+    CHECK(a.generation == b.generation);
+    CHECK(a.heap == b.heap);
+    CHECK(a.population.size() == b.population.size() && a.population.numCities() == b.population.numCities());
+    for (size_t i = 0; i < a.population.size() && i < b.population.size(); ++i) {
+        ConstRouteView x = a.population.route(i);
+        ConstRouteView y = b.population.route(i);
+        CHECK(x.length == y.length);
+        CHECK(std::equal(x.order, x.order + x.n, y.order));
+        for (size_t k = 0; k < y.n; ++k) {
+            CHECK(y.positionOf(y.order[k]) == k);
+        }
+    }
+}
+
+void testRoundTrip(size_t size, size_t cities, bool steady) {
+    std::string path = temporaryPath("roundtrip");
+    Checkpoint original = randomCheckpoint(size, cities, steady);
+    saveCheckpoint(path, original);
+    checkSame(original, loadCheckpoint(path));
+    ::unlink(path.c_str());
+}
+
+void testCorruption() {
+    std::string path = temporaryPath("corrupt");
+    saveCheckpoint(path, randomCheckpoint(20, 300, true));
+    std::vector<unsigned char> good = readBytes(path);
+
+    for (size_t cut: {size_t(0), size_t(7), size_t(40), good.size() / 2, good.size() - 1}) {
+        writeBytes(path, std::vector<unsigned char>(good.begin(), good.begin() + static_cast<long>(cut)));
+        CHECK_THROWS(loadCheckpoint(path), std::runtime_error);
+    }
+    for (size_t at: {size_t(0), size_t(9), size_t(60), good.size() / 2, good.size() - 3}) {
+        std::vector<unsigned char> bad = good;
+        bad[at] ^= 0x10;
+        writeBytes(path, bad);
+        CHECK_THROWS(loadCheckpoint(path), std::runtime_error);
+    }
+    ::unlink(path.c_str());
+    CHECK_THROWS(loadCheckpoint(path), std::runtime_error);
+}
+
+// Heaps with a valid checksum that would still make replaceWorst overwrite the wrong routes
+void testInvalidHeaps() {
+    std::string path = temporaryPath("heap");
+    Checkpoint checkpoint = randomCheckpoint(10, 50, true);
+    auto length = [&](size_t i) { return checkpoint.population.length(i); };
+
+    Checkpoint duplicate = randomCheckpoint(10, 50, true);
+    duplicate.heap[3] = duplicate.heap[4];
+    saveCheckpoint(path, duplicate);
+    CHECK_THROWS(loadCheckpoint(path), std::runtime_error);
+
+    Checkpoint unordered = randomCheckpoint(10, 50, true);
+    std::swap(unordered.heap.front(), unordered.heap.back());
+    saveCheckpoint(path, unordered);
+    CHECK_THROWS(loadCheckpoint(path), std::runtime_error);
+    ::unlink(path.c_str());
+
+    WorstHeap heap;
+    CHECK_THROWS(heap.restore(duplicate.heap, length, false), std::invalid_argument);
+    CHECK_THROWS(heap.restore(unordered.heap, length, false), std::invalid_argument);
+    heap.restore(checkpoint.heap, length, false);
+    CHECK(heap.slots() == checkpoint.heap);
+}
+
+} // namespace
+
+int main() {
+    testRoundTrip(1, 1, false);
+    testRoundTrip(3, 2, true);
+    testRoundTrip(50, 100, false);
+    testRoundTrip(16, 1000, true);
+    testCorruption();
+    testInvalidHeaps();
+    return checkResult();
+}
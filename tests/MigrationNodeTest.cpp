@@ -0,0 +1,310 @@
+// Wire format of the distributed island model: bit-packed city ids (tsp/Codec.h) and migrant
+// frames between MigrationNodes on Unix domain sockets, including peers that send malformed frames
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "common/Random.h"
+#include "tests/Check.h"
+#include "tsp/Cities.h"
+#include "tsp/Codec.h"
+#include "tsp/MigrationNode.h"
+
+namespace {
+
+void testIdWidth() {
+    CHECK(cityIdWidth(1) == 1);
+    CHECK(cityIdWidth(2) == 1);
+    CHECK(cityIdWidth(3) == 2);
+    CHECK(cityIdWidth(256) == 8);
+    CHECK(cityIdWidth(257) == 9);
+    CHECK(cityIdWidth(100000) == 17);
+}
+
+void testIdRoundTrip(size_t n) {
+    Rng rng(n);
+    std::vector<std::vector<CityId>> routes(3, std::vector<CityId>(n));
+    std::vector<unsigned char> bytes;
+    ByteEncoder encoder(bytes);
+    encoder.u32(0xdeadbeef);
+    for (auto &route: routes) {
+        std::iota(route.begin(), route.end(), CityId(0));
+        std::shuffle(route.begin(), route.end(), rng);
+        encoder.ids(route.data(), n, cityIdWidth(n));
+    }
+    encoder.flushIds();
+    encoder.f64(-2.5);
+    CHECK(bytes.size() == 4 + (3 * n * cityIdWidth(n) + 7) / 8 + 8);
+
+    std::string source = "round trip";
+    ByteDecoder decoder(source, bytes.data(), bytes.data() + bytes.size());
+    CHECK(decoder.u32() == 0xdeadbeef);
+    std::vector<CityId> decoded(n);
+    for (const auto &route: routes) {
+        decoder.ids(decoded.data(), n, cityIdWidth(n));
+        CHECK(decoded == route);
+    }
+    decoder.skipIdPadding();
+    CHECK(decoder.f64() == -2.5);
+    CHECK(decoder.position() == bytes.data() + bytes.size());
+
+    // Every shorter input is truncated
+    for (size_t cut: {size_t(0), size_t(3), bytes.size() / 2, bytes.size() - 1}) {
+        ByteDecoder truncated(source, bytes.data(), bytes.data() + cut);
+        CHECK_THROWS({
+            truncated.u32();
+            for (int r = 0; r < 3; ++r) truncated.ids(decoded.data(), n, cityIdWidth(n));
+            truncated.skipIdPadding();
+            truncated.f64();
+        }, std::runtime_error);
+    }
+}
+
+void testIdOutOfRange() {
+    // 3 cities take 2 bits per id, which can also encode the invalid id 3
+    std::vector<CityId> order = {0, 3, 1};
+    std::vector<unsigned char> bytes;
+    ByteEncoder encoder(bytes);
+    encoder.ids(order.data(), order.size(), cityIdWidth(3));
+    encoder.flushIds();
+    std::string source = "out of range";
+    ByteDecoder decoder(source, bytes.data(), bytes.data() + bytes.size());
+    std::vector<CityId> decoded(3);
+    CHECK_THROWS(decoder.ids(decoded.data(), 3, cityIdWidth(3)), std::runtime_error);
+}
+
+std::string socketPath(const std::string &name) {
+    return "/tmp/ga_node_test_" + std::to_string(::getpid()) + "_" + name + ".sock";
+}
+
+NodeOptions nodeOptions(const std::vector<std::string> &paths, int rank) {
+    NodeOptions options;
+    for (const std::string &path: paths) {
+        options.peers.push_back("unix:" + path);
+    }
+    options.rank = rank;
+    options.connectTimeout = 5.0;
+    return options;
+}
+
+// Poll `node` for a migrant for up to a few seconds
+bool receiveWithin(MigrationNode &node, RouteView dst) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (node.receive(dst)) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+Route shuffledRoute(const Instance &instance, uint64_t seed) {
+    std::vector<CityId> order(instance.size());
+    std::iota(order.begin(), order.end(), CityId(0));
+    Rng rng(seed);
+    std::shuffle(order.begin(), order.end(), rng);
+    return Route(instance, order);
+}
+
+void testExchange(const Instance &instance) {
+    std::vector<std::string> paths = {socketPath("ring0"), socketPath("ring1")};
+    // Each constructor waits for the other node to connect, so they are built concurrently
+    std::unique_ptr<MigrationNode> node1;
+    std::thread starter([&] { node1 = std::make_unique<MigrationNode>(nodeOptions(paths, 1), instance, 4); });
+    auto node0 = std::make_unique<MigrationNode>(nodeOptions(paths, 0), instance, 4);
+    starter.join();
+
+    Route first = shuffledRoute(instance, 1);
+    Route second = shuffledRoute(instance, 2);
+    Population arrival(1, instance.size());
+    node0->send(first.view());
+    CHECK(receiveWithin(*node1, arrival.route(0)));
+    CHECK(std::equal(first.order.begin(), first.order.end(), arrival.route(0).order));
+    CHECK(arrival.length(0) == first.length);
+    for (size_t k = 0; k < instance.size(); ++k) {
+        CHECK(arrival.route(0).positionOf(first.order[k]) == k);
+    }
+    node1->send(second.view());
+    CHECK(receiveWithin(*node0, arrival.route(0)));
+    CHECK(std::equal(second.order.begin(), second.order.end(), arrival.route(0).order));
+    CHECK(node0->sent() == 1 && node0->received() == 1);
+
+    // Node 0 ends up with the shorter of the two best routes
+    const Route &shorter = first.length < second.length ? first : second;
+    std::thread finisher([&] {
+        CHECK(node1->gatherBest(second).order == second.order);
+        node1.reset();
+    });
+    CHECK(node0->gatherBest(first).order == shorter.order);
+    // Node 1 keeps listening until node 0, which sends to it, has hung up
+    node0.reset();
+    finisher.join();
+}
+
+// A hand-made "node 1": it listens where node 0 connects to it and dials node 0 itself
+class RawPeer {
+public:
+    explicit RawPeer(const std::string &listenPath) {
+        listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address = unixAddress(listenPath);
+        ::unlink(listenPath.c_str());
+        CHECK(::bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0);
+        CHECK(::listen(listener, 4) == 0);
+        path = listenPath;
+    }
+
+    ~RawPeer() {
+        if (fd >= 0) ::close(fd);
+        ::close(listener);
+        ::unlink(path.c_str());
+    }
+
+    void connectTo(const std::string &nodePath) {
+        sockaddr_un address = unixAddress(nodePath);
+        for (int attempt = 0; attempt < 500; ++attempt) {
+            fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0) return;
+            ::close(fd);
+            fd = -1;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        CHECK(fd >= 0);
+    }
+
+    void hello(uint64_t fingerprint, uint32_t cities) {
+        std::vector<unsigned char> frame;
+        ByteEncoder encoder(frame);
+        encoder.u32(20);
+        encoder.u32(1); // hello
+        encoder.u32(1); // rank
+        encoder.u64(fingerprint);
+        encoder.u32(cities);
+        send(frame);
+    }
+
+    void send(const std::vector<unsigned char> &bytes) {
+        CHECK(::send(fd, bytes.data(), bytes.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(bytes.size()));
+    }
+
+    void hangUp() {
+        ::close(fd);
+        fd = -1;
+    }
+
+private:
+    int listener = -1;
+    int fd = -1;
+    std::string path;
+
+    static sockaddr_un unixAddress(const std::string &path) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        return address;
+    }
+};
+
+// A migrant frame whose size field and payload are `payload` bytes long
+std::vector<unsigned char> migrantFrame(size_t payload) {
+    std::vector<unsigned char> frame;
+    ByteEncoder encoder(frame);
+    encoder.u32(static_cast<uint32_t>(payload));
+    encoder.u32(2); // migrant
+    frame.resize(4 + payload, 0);
+    return frame;
+}
+
+void testMalformedFrames(const Instance &instance) {
+    std::vector<std::string> paths = {socketPath("bad0"), socketPath("bad1")};
+    size_t routeFrame = 4 + 8 + (instance.size() * cityIdWidth(instance.size()) + 7) / 8;
+
+    // A peer solving another instance is rejected at the startup barrier
+    {
+        RawPeer peer(paths[1]);
+        std::thread dialer([&] {
+            peer.connectTo(paths[0]);
+            peer.hello(instanceFingerprint(instance) + 1, static_cast<uint32_t>(instance.size()));
+        });
+        CHECK_THROWS(MigrationNode(nodeOptions(paths, 0), instance, 4), std::runtime_error);
+        dialer.join();
+    }
+
+    // Migrant frames of the wrong size, whatever their content, are errors of the node
+    for (size_t payload: {routeFrame - 1, routeFrame + 8}) {
+        RawPeer peer(paths[1]);
+        std::thread dialer([&] {
+            peer.connectTo(paths[0]);
+            peer.hello(instanceFingerprint(instance), static_cast<uint32_t>(instance.size()));
+        });
+        MigrationNode node(nodeOptions(paths, 0), instance, 4);
+        dialer.join();
+        peer.send(migrantFrame(payload));
+        Population arrival(1, instance.size());
+        CHECK_THROWS(receiveWithin(node, arrival.route(0)), std::runtime_error);
+        peer.hangUp();
+    }
+
+    // A migrant claiming a shorter tour than it is arrives with its true length
+    {
+        RawPeer peer(paths[1]);
+        std::thread dialer([&] {
+            peer.connectTo(paths[0]);
+            peer.hello(instanceFingerprint(instance), static_cast<uint32_t>(instance.size()));
+        });
+        MigrationNode node(nodeOptions(paths, 0), instance, 4);
+        dialer.join();
+        Route route = shuffledRoute(instance, 3);
+        std::vector<unsigned char> frame;
+        ByteEncoder encoder(frame);
+        encoder.u32(static_cast<uint32_t>(routeFrame));
+        encoder.u32(2); // migrant
+        encoder.f64(route.length / 100);
+        encoder.ids(route.order.data(), route.order.size(), cityIdWidth(instance.size()));
+        encoder.flushIds();
+        peer.send(frame);
+        Population arrival(1, instance.size());
+        CHECK(receiveWithin(node, arrival.route(0)));
+        CHECK(std::equal(route.order.begin(), route.order.end(), arrival.route(0).order));
+        CHECK(arrival.length(0) == route.length);
+        peer.hangUp();
+    }
+
+    // A frame of the right size that is not a permutation
+    {
+        RawPeer peer(paths[1]);
+        std::thread dialer([&] {
+            peer.connectTo(paths[0]);
+            peer.hello(instanceFingerprint(instance), static_cast<uint32_t>(instance.size()));
+        });
+        MigrationNode node(nodeOptions(paths, 0), instance, 4);
+        dialer.join();
+        peer.send(migrantFrame(routeFrame)); // all ids 0
+        Population arrival(1, instance.size());
+        CHECK_THROWS(receiveWithin(node, arrival.route(0)), std::runtime_error);
+        peer.hangUp();
+    }
+}
+
+} // namespace
+
+int main() {
+    testIdWidth();
+    for (size_t n: {size_t(1), size_t(2), size_t(3), size_t(50), size_t(256), size_t(257), size_t(5000)}) {
+        testIdRoundTrip(n);
+    }
+    testIdOutOfRange();
+
+    Instance instance(defaultCities(), "default50");
+    testExchange(instance);
+    testMalformedFrames(instance);
+    return checkResult();
+}
@@ -0,0 +1,92 @@
+// SharedPopulation: readers racing writers that call tryReplace must only ever see routes that
+// some writer published as a whole, never a mix of two routes or a length of another route
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "tests/Check.h"
+#include "tsp/SharedPopulation.h"
+
+namespace {
+
+const size_t CITIES = 257;
+const double TOP = 1e9;
+
+// Route number `serial` is the identity rotated by serial % CITIES, with length TOP - serial, so
+// a reader can tell from the order alone which length belongs to it
+void makeRoute(uint64_t serial, RouteView route) {
+    for (size_t k = 0; k < CITIES; ++k) {
+        route.order[k] = static_cast<CityId>((k + serial) % CITIES);
+    }
+    route.rebuildPositions();
+    *route.length = TOP - static_cast<double>(serial);
+}
+
+bool consistent(ConstRouteView route) {
+    auto serial = static_cast<uint64_t>(TOP - route.length);
+    for (size_t k = 0; k < CITIES; ++k) {
+        if (route.order[k] != (k + serial) % CITIES || route.positionOf(route.order[k]) != k) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    const size_t slots = 4;
+    const int writers = 2;
+    const int readers = 2;
+    const uint64_t writes = 20000;
+
+    Population initial(slots, CITIES);
+    for (size_t i = 0; i < slots; ++i) {
+        makeRoute(0, initial.route(i));
+    }
+    SharedPopulation shared(initial);
+
+    std::atomic<uint64_t> serials{1};
+    std::atomic<uint64_t> published{0};
+    std::atomic<int> writing{writers};
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&, w] {
+            Population route(1, CITIES);
+            for (uint64_t k = 0; k < writes; ++k) {
+                uint64_t serial = serials.fetch_add(1);
+                makeRoute(serial, route.route(0));
+                if (shared.tryReplace((serial + w) % slots, route.route(0))) ++published;
+            }
+            --writing;
+        });
+    }
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r] {
+            Population copy(1, CITIES);
+            size_t i = static_cast<size_t>(r);
+            while (writing > 0) {
+                shared.read(i, copy.route(0));
+                CHECK(consistent(copy.route(0)));
+                i = (i + 1) % slots;
+            }
+        });
+    }
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+
+    // Slots only ever get shorter, and the final contents are intact
+    CHECK(published > 0);
+    Population final(slots, CITIES);
+    shared.snapshot(final);
+    for (size_t i = 0; i < slots; ++i) {
+        CHECK(consistent(final.route(i)));
+        CHECK(final.length(i) < TOP);
+        CHECK(shared.length(i) == final.length(i));
+    }
+    // A longer route never replaces a shorter one
+    Population longer(1, CITIES);
+    makeRoute(0, longer.route(0));
+    CHECK(!shared.tryReplace(0, longer.route(0)));
+    return checkResult();
+}
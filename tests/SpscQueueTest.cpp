@@ -0,0 +1,129 @@
+// SpscQueue: full/empty at capacity, wrap-around of the slot index, FIFO order between a
+// concurrent producer and consumer, and the Reporter retrying pushes while its writer lags behind
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "common/Reporter.h"
+#include "common/SpscQueue.h"
+#include "tests/Check.h"
+
+static void testWrapAround() {
+    SpscQueue<int> queue(3);
+    int value = -1;
+    CHECK(!queue.tryPop(value));
+    int next = 0;
+    int expected = 0;
+    // Fill and drain by uneven amounts so the counters pass the capacity many times
+    for (int round = 0; round < 100; ++round) {
+        int pushes = 1 + round % 3;
+        for (int k = 0; k < pushes; ++k) {
+            CHECK(queue.tryPush(next++));
+        }
+        while (queue.tryPop(value)) {
+            CHECK(value == expected);
+            ++expected;
+        }
+    }
+    CHECK(expected == next);
+
+    for (int k = 0; k < 3; ++k) {
+        CHECK(queue.tryPush(k));
+    }
+    CHECK(!queue.tryPush(3));
+    CHECK(queue.tryPop(value) && value == 0);
+    CHECK(queue.tryPush(3));
+    for (int k = 1; k <= 3; ++k) {
+        CHECK(queue.tryPop(value) && value == k);
+    }
+    CHECK(!queue.tryPop(value));
+}
+
+static void testConcurrentOrder() {
+    const uint64_t count = 200000;
+    SpscQueue<uint64_t> queue(16);
+    std::thread producer([&] {
+        for (uint64_t i = 0; i < count; ++i) {
+            while (!queue.tryPush(i)) std::this_thread::yield();
+        }
+    });
+    uint64_t expected = 0;
+    uint64_t value;
+    while (expected < count) {
+        if (queue.tryPop(value)) {
+            CHECK(value == expected);
+            expected = value + 1;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    CHECK(!queue.tryPop(value));
+}
+
+static void testFullPushKeepsValue() {
+    SpscQueue<std::unique_ptr<int>> queue(1);
+    auto first = std::make_unique<int>(1);
+    auto second = std::make_unique<int>(2);
+    CHECK(queue.tryPush(std::move(first)));
+    CHECK(!queue.tryPush(std::move(second)));
+    CHECK(second && *second == 2);
+    std::unique_ptr<int> value;
+    CHECK(queue.tryPop(value) && *value == 1);
+    CHECK(queue.tryPush(std::move(second)));
+    CHECK(!second);
+    CHECK(queue.tryPop(value) && value && *value == 2);
+}
+
+// Many more dumps than the reporter's queue holds, written to a pipe whose reader starts late so
+// that the GA side has to retry its pushes
+static void testReporterBackPressure() {
+    const int count = 20000;
+    ReportOptions options;
+    options.verbosity = Verbosity::Full;
+    options.path = "/tmp/ga_reporter_test_" + std::to_string(::getpid()) + ".fifo";
+    ::unlink(options.path.c_str());
+    CHECK(::mkfifo(options.path.c_str(), 0600) == 0);
+
+    int records = 0;
+    int dumps = 0;
+    int garbled = 0;
+    std::thread reader([&] {
+        std::ifstream in(options.path);
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.rfind("Generation ", 0) == 0) {
+                garbled += line.rfind("Generation " + std::to_string(records) + ": best 1,", 0) != 0;
+                ++records;
+            } else {
+                garbled += line != "dump " + std::to_string(dumps);
+                ++dumps;
+            }
+        }
+    });
+    {
+        Reporter reporter(options);
+        for (int k = 0; k < count; ++k) {
+            reporter.record({k, 0.0, 1.0, 2.0, 0.5});
+            reporter.dump("dump " + std::to_string(k) + "\n");
+        }
+    }
+    reader.join();
+    CHECK(garbled == 0);
+    CHECK(records == count && dumps == count);
+    ::unlink(options.path.c_str());
+}
+
+int main() {
+    testWrapAround();
+    testConcurrentOrder();
+    testFullPushKeepsValue();
+    testReporterBackPressure();
+    return checkResult();
+}
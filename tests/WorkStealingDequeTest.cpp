@@ -0,0 +1,101 @@
+// WorkStealingDeque: capacity limits, LIFO pops and FIFO steals on one thread, and a stress test in
+// which the owner pushes and pops while thieves steal, checking every item is taken exactly once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "common/WorkStealingDeque.h"
+#include "tests/Check.h"
+
+static void testSingleThread() {
+    WorkStealingDeque<int64_t> deque(3);
+    CHECK(deque.capacity() == 4);
+    CHECK(deque.empty());
+    int64_t item = -1;
+    CHECK(!deque.tryPop(item));
+    CHECK(!deque.trySteal(item));
+    for (int64_t k = 0; k < 4; ++k) {
+        CHECK(deque.tryPush(k));
+    }
+    CHECK(!deque.tryPush(4));
+    CHECK(deque.trySteal(item) && item == 0); // oldest
+    CHECK(deque.tryPop(item) && item == 3);   // newest
+    CHECK(deque.tryPush(5));
+    CHECK(deque.tryPush(6));
+    CHECK(!deque.tryPush(7));
+    CHECK(deque.tryPop(item) && item == 6);
+    CHECK(deque.tryPop(item) && item == 5);
+    CHECK(deque.tryPop(item) && item == 2);
+    CHECK(deque.trySteal(item) && item == 1);
+    CHECK(deque.empty());
+    CHECK(!deque.tryPop(item));
+}
+
+static void testConcurrentSteals() {
+    const int64_t items = 200000;
+    const int thieves = 3;
+    WorkStealingDeque<int64_t> deque(64);
+    std::unique_ptr<std::atomic<int>[]> taken(new std::atomic<int>[items]);
+    for (int64_t i = 0; i < items; ++i) {
+        taken[i].store(0);
+    }
+    std::atomic<bool> done{false};
+    std::atomic<int64_t> stolen{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thieves; ++t) {
+        threads.emplace_back([&] {
+            int64_t item;
+            while (!done) {
+                if (deque.trySteal(item)) {
+                    CHECK(item >= 0 && item < items);
+                    ++taken[item];
+                    ++stolen;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // The owner pushes in bursts and pops some items itself, racing the thieves for the last one
+    int64_t next = 0;
+    int64_t popped = 0;
+    int64_t item;
+    while (next < items) {
+        for (int k = 0; k < 7 && next < items; ++k) {
+            if (deque.tryPush(next)) {
+                ++next;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        for (int k = 0; k < 3 && deque.tryPop(item); ++k) {
+            ++taken[item];
+            ++popped;
+        }
+    }
+    while (deque.tryPop(item)) {
+        ++taken[item];
+        ++popped;
+    }
+    done = true;
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+
+    CHECK(popped + stolen == items);
+    int64_t wrong = 0;
+    for (int64_t i = 0; i < items; ++i) {
+        if (taken[i] != 1) ++wrong;
+    }
+    CHECK(wrong == 0);
+}
+
+int main() {
+    testSingleThread();
+    testConcurrentSteals();
+    return checkResult();
+}
@@ -0,0 +1,97 @@
+#include "tsp/AsyncEngine.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include <omp.h>
+
+#include "tsp/SharedPopulation.h"
+
+// Number of random slots whose longest route a new child competes with
+static const int WORST_TOURNAMENT = 4;
+
+// Binary tournament on the published lengths
+static size_t selectParent(const SharedPopulation &population, Rng &rng) {
+    uint32_t index1 = rng.below(static_cast<uint32_t>(population.size()));
+    uint32_t index2 = rng.below(static_cast<uint32_t>(population.size()));
+    return population.length(index1) < population.length(index2) ? index1 : index2;
+}
+
+static size_t selectWorst(const SharedPopulation &population, Rng &rng) {
+    size_t worst = rng.below(static_cast<uint32_t>(population.size()));
+    for (int k = 1; k < WORST_TOURNAMENT; ++k) {
+        size_t other = rng.below(static_cast<uint32_t>(population.size()));
+        if (population.length(other) > population.length(worst)) {
+            worst = other;
+        }
+    }
+    return worst;
+}
+
+Route runAsyncSteadyState(const Instance &instance, const GAParameters &params,
+                          const GenerationObserver &observer, StopCondition *stop) {
+    size_t n = instance.size();
+    int64_t size = params.populationSize;
+    Population initial = initializePopulation(instance, params, true);
+    std::unique_ptr<LocalSearch> localSearch;
+    if (params.localSearch) {
+        localSearch = std::make_unique<LocalSearch>(instance, params.candidates);
+        improvePopulation(*localSearch, initial, true);
+    }
+    if (observer) observer(0, initial);
+    if (stop) {
+        stop->addEvaluations(size);
+        stop->update(0, initial.length(initial.bestIndex()));
+    }
+
+    SharedPopulation shared(initial);
+    const int64_t budget = size * params.numGenerations;
+    std::atomic<int64_t> tickets{0};
+    int reported = 0; // last generation handed to the observer and the stop condition
+    Population snapshot = observer ? Population(params.populationSize, n) : Population();
+
+    #pragma omp parallel default(none) shared(instance, params, observer, stop, n, size, localSearch, shared, \
+                                              budget, tickets, reported, snapshot)
+    {
+        // Two parents and the child, private to the thread
+        Population local(3, n);
+        RouteView parent1 = local.route(0), parent2 = local.route(1), child = local.route(2);
+
+        while (!(stop && stop->stopped())) {
+            int64_t ticket = tickets.fetch_add(1, std::memory_order_relaxed);
+            if (ticket >= budget) {
+                break;
+            }
+            int generation = static_cast<int>(ticket / size) + 1;
+            Rng rng = childRng(params, generation, static_cast<int>(ticket % size));
+            shared.read(selectParent(shared, rng), parent1);
+            shared.read(selectParent(shared, rng), parent2);
+            crossover(instance, parent1, parent2, child, params.crossoverRate, params.crossover, rng);
+            mutate(instance, child, params.mutationRate, params.mutationMove, rng);
+            if (localSearch) {
+                localSearch->improve(child, parent1);
+            }
+            shared.tryReplace(selectWorst(shared, rng), child);
+            if (stop) stop->addEvaluations(1);
+
+            // Whoever finishes the last ticket of a generation reports it; the children of the next
+            // generation may already be in the snapshot, and a report that has been overtaken is dropped
+            if (ticket % size == size - 1 && (observer || stop)) {
+                #pragma omp critical(async_report)
+                if (generation > reported) {
+                    reported = generation;
+                    if (observer) {
+                        shared.snapshot(snapshot);
+                        observer(generation, snapshot);
+                    }
+                    if (stop) stop->update(generation, shared.length(shared.bestIndex()));
+                }
+            }
+        }
+    }
+
+    Population best(1, n);
+    shared.read(shared.bestIndex(), best.route(0));
+    return Route(best.route(0));
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "tsp/GeneticAlgorithm.h"
+
+// Asynchronous steady-state GA: every OpenMP thread loops on its own, picking parents by binary
+// tournament from a SharedPopulation, building a child with the regular crossover, mutation and
+// (optional) local search, and publishing it over the longest of a few randomly drawn routes
+// (a tournament of the worst) if it is shorter. There are no generations, barriers or locks;
+// threads that are slowed down (by longer local searches, say) simply publish fewer children.
+//
+// The run ends after params.numGenerations * params.populationSize children, the same number of
+// evaluations as the generational engines, or when the stop condition fires. Every child still
+// draws from the random stream of its ticket number, but which routes it sees depends on timing,
+// so runs are not bit-reproducible.
+//
+// The observer and the stop condition are called every populationSize children, by the thread that
+// finishes the last of them, with a snapshot of the shared population; the generation they are
+// given is the number of such batches.
+Route runAsyncSteadyState(const Instance &instance, const GAParameters &params,
+                          const GenerationObserver &observer = {}, StopCondition *stop = nullptr);
@@ -0,0 +1,282 @@
+#include "tsp/Checkpoint.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "common/MappedFile.h"
+#include "common/Profiler.h"
+#include "tsp/Codec.h"
+
+namespace {
+
+const char MAGIC[8] = {'T', 'S', 'P', 'G', 'A', 'C', 'K', '1'};
+const uint32_t VERSION = 1;
+
+void writeFile(const std::string &path, const std::vector<unsigned char> &data) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "cannot create " + path);
+    }
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t count = ::write(fd, data.data() + written, data.size() - written);
+        if (count < 0 && errno == EINTR) continue;
+        if (count < 0) {
+            int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "cannot write " + path);
+        }
+        written += static_cast<size_t>(count);
+    }
+    // The descriptor is closed even if the sync fails; the first error is reported
+    int error = ::fsync(fd) != 0 ? errno : 0;
+    if (::close(fd) != 0 && error == 0) error = errno;
+    if (error != 0) {
+        throw std::system_error(error, std::generic_category(), "cannot write " + path);
+    }
+}
+
+// Makes a rename inside the directory of `path` durable
+void syncDirectory(const std::string &path) {
+    size_t slash = path.rfind('/');
+    std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+    int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "cannot open directory " + directory);
+    }
+    int error = ::fsync(fd) != 0 ? errno : 0;
+    ::close(fd);
+    if (error != 0) {
+        throw std::system_error(error, std::generic_category(), "cannot sync directory " + directory);
+    }
+}
+
+} // namespace
+
+uint64_t settingsFingerprint(const GAParameters &params) {
+    Fnv fnv;
+    fnv.add(params.populationSize);
+    fnv.add(params.mutationRate);
+    fnv.add(params.crossoverRate);
+    fnv.add(static_cast<int>(params.replacement));
+    fnv.add(params.elites);
+    fnv.add(static_cast<int>(params.crossover));
+    fnv.add(static_cast<int>(params.mutationMove));
+    fnv.add(params.localSearch);
+    fnv.add(params.localSearch ? params.candidates : 0);
+    return fnv.value();
+}
+
+void saveCheckpoint(const std::string &path, const Checkpoint &checkpoint) {
+    const Population &population = checkpoint.population;
+    size_t n = population.numCities();
+    int width = cityIdWidth(n);
+    std::vector<unsigned char> data;
+    data.reserve(64 + population.size() * (8 + 4 + n * width / 8 + 1));
+    ByteEncoder encoder(data);
+    encoder.bytes(MAGIC, sizeof(MAGIC));
+    encoder.u32(VERSION);
+    encoder.u32(static_cast<uint32_t>(width));
+    encoder.u64(checkpoint.seed);
+    encoder.u64(checkpoint.settings);
+    encoder.u64(checkpoint.instance);
+    encoder.u32(static_cast<uint32_t>(n));
+    encoder.u32(static_cast<uint32_t>(population.size()));
+    encoder.u32(static_cast<uint32_t>(checkpoint.generation));
+    encoder.u32(static_cast<uint32_t>(checkpoint.heap.size()));
+    for (size_t i = 0; i < population.size(); ++i) {
+        encoder.f64(population.length(i));
+    }
+    for (size_t slot: checkpoint.heap) {
+        encoder.u32(static_cast<uint32_t>(slot));
+    }
+    for (size_t i = 0; i < population.size(); ++i) {
+        encoder.ids(population.route(i).order, n, width);
+    }
+    encoder.flushIds();
+    Fnv checksum;
+    checksum.add(data.data(), data.size());
+    encoder.u64(checksum.value());
+
+    std::string temporary = path + ".tmp";
+    writeFile(temporary, data);
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        throw std::system_error(errno, std::generic_category(), "cannot rename " + temporary + " to " + path);
+    }
+    syncDirectory(path);
+}
+
+Checkpoint loadCheckpoint(const std::string &path) {
+    MappedFile file(path);
+    auto *begin = reinterpret_cast<const unsigned char *>(file.view().data());
+    ByteDecoder decoder(path, begin, begin + file.view().size());
+    char magic[sizeof(MAGIC)];
+    decoder.bytes(magic, sizeof(magic));
+    if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) decoder.fail("not a checkpoint file");
+    uint32_t version = decoder.u32();
+    if (version != VERSION) decoder.fail("unsupported checkpoint version " + std::to_string(version));
+    int width = static_cast<int>(decoder.u32());
+
+    Checkpoint checkpoint;
+    checkpoint.seed = decoder.u64();
+    checkpoint.settings = decoder.u64();
+    checkpoint.instance = decoder.u64();
+    size_t n = decoder.u32();
+    size_t size = decoder.u32();
+    checkpoint.generation = static_cast<int>(decoder.u32());
+    size_t heapSize = decoder.u32();
+    if (n == 0 || size == 0 || width != cityIdWidth(n) || (heapSize != 0 && heapSize != size)) {
+        decoder.fail("inconsistent checkpoint header");
+    }
+
+    checkpoint.population = Population(size, n);
+    Population &population = checkpoint.population;
+    for (size_t i = 0; i < size; ++i) {
+        *population.route(i).length = decoder.f64();
+    }
+    checkpoint.heap.resize(heapSize);
+    // The slots must be a permutation in heap order (longest tour on top), or replaceWorst would
+    // overwrite the wrong routes
+    std::vector<bool> inHeap(size, false);
+    for (size_t i = 0; i < heapSize; ++i) {
+        size_t slot = checkpoint.heap[i] = decoder.u32();
+        if (slot >= size || inHeap[slot]) decoder.fail("heap slots are not a permutation of the population");
+        inHeap[slot] = true;
+        if (i > 0 && population.length(slot) > population.length(checkpoint.heap[(i - 1) / 2])) {
+            decoder.fail("heap slots are not in heap order");
+        }
+    }
+    for (size_t i = 0; i < size; ++i) {
+        decoder.ids(population.route(i).order, n, width);
+    }
+    decoder.skipIdPadding();
+    Fnv checksum;
+    checksum.add(begin, static_cast<size_t>(decoder.position() - begin));
+    if (decoder.u64() != checksum.value()) decoder.fail("checksum mismatch (corrupt checkpoint)");
+
+    for (size_t i = 0; i < size; ++i) {
+        RouteView route = population.route(i);
+        route.rebuildPositions();
+        std::vector<bool> seen(n, false);
+        for (size_t k = 0; k < n; ++k) {
+            if (seen[route.order[k]]) decoder.fail("route " + std::to_string(i) + " is not a permutation");
+            seen[route.order[k]] = true;
+        }
+    }
+    return checkpoint;
+}
+
+void checkResumable(const Checkpoint &checkpoint, const GAParameters &params, const Instance &instance) {
+    if (checkpoint.instance != instanceFingerprint(instance)) {
+        throw std::invalid_argument("the checkpoint was written for a different instance");
+    }
+    if (checkpoint.seed != params.seed) {
+        throw std::invalid_argument("the checkpoint was written with seed " + std::to_string(checkpoint.seed));
+    }
+    if (checkpoint.settings != settingsFingerprint(params)) {
+        throw std::invalid_argument("the checkpoint was written with different GA settings (population, "
+                                    "rates, operators, replacement, elites or local search)");
+    }
+    bool steady = params.replacement == Replacement::SteadyState;
+    if (steady != !checkpoint.heap.empty()) {
+        throw std::invalid_argument("the checkpoint was written with a different replacement model");
+    }
+}
+
+Checkpointer::Checkpointer(std::string path, int interval, std::unique_ptr<Checkpoint> resume)
+        : path(std::move(path)), interval(interval), resume(std::move(resume)) {
+    if (interval < 1) {
+        throw std::invalid_argument("the checkpoint interval must be at least 1 generation");
+    }
+    if (!this->path.empty()) {
+        writer = std::thread(&Checkpointer::run, this);
+    }
+}
+
+Checkpointer::~Checkpointer() {
+    if (writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+        }
+        wake.notify_all();
+        writer.join();
+    }
+}
+
+void Checkpointer::offer(const GAParameters &params, const Instance &instance, int generation,
+                         const Population &population, const WorstHeap *heap, bool wait) {
+    if (path.empty()) {
+        return;
+    }
+    GA_PROFILE_ZONE(Checkpoint);
+    std::unique_lock<std::mutex> lock(mutex);
+    if (wait) {
+        wake.wait(lock, [&] { return !busy; });
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    if (busy) {
+        ++skips;
+        return;
+    }
+    if (pending.population.size() != population.size() || pending.population.numCities() != population.numCities()) {
+        pending.population = Population(population.size(), population.numCities());
+        pending.instance = instanceFingerprint(instance);
+    }
+    for (size_t i = 0; i < population.size(); ++i) {
+        pending.population.route(i).assign(population.route(i));
+    }
+    pending.seed = params.seed;
+    pending.settings = settingsFingerprint(params);
+    pending.generation = generation;
+    pending.heap = heap ? heap->slots() : std::vector<size_t>();
+    busy = true;
+    lock.unlock();
+    wake.notify_all();
+}
+
+void Checkpointer::finish() {
+    if (path.empty()) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    wake.wait(lock, [&] { return !busy; });
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void Checkpointer::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [&] { return busy || done; });
+        if (!busy) {
+            return;
+        }
+        // The GA thread leaves `pending` alone while busy is set
+        lock.unlock();
+        std::exception_ptr failure;
+        try {
+            saveCheckpoint(path, pending);
+        } catch (...) {
+            failure = std::current_exception();
+        }
+        lock.lock();
+        if (failure) {
+            if (!error) error = failure;
+        } else {
+            ++writes;
+        }
+        busy = false;
+        wake.notify_all();
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/WorstHeap.h"
+#include "tsp/Codec.h"
+#include "tsp/GeneticAlgorithm.h"
+#include "tsp/Instance.h"
+#include "tsp/Population.h"
+
+// Checkpoints of the generational engine (serial, omp and task policies). Since every random draw
+// derives from the seed and the generation (see childRng), the population after a generation, the
+// generation number and the seed are the whole state of a run; steady-state runs add the layout of
+// their WorstHeap. A run resumed from a checkpoint therefore continues bit for bit like the
+// original one. Stop criteria start afresh, apart from the evaluation count.
+//
+// File format (version 1, integers little-endian):
+//   "TSPGACK1", u32 version, u32 bits per city id, u64 seed, u64 settings fingerprint,
+//   u64 instance fingerprint, u32 cities, u32 population size, u32 generation, u32 heap slots,
+//   f64 tour length per route, u32 slot per heap entry, the city orders of all routes back to back
+//   as a bit stream of ids of the given width, u64 FNV-1a checksum of everything before it
+
+// State of a run after a generation
+struct Checkpoint {
+    uint64_t seed = 0;
+    uint64_t settings = 0; // settingsFingerprint of the run's parameters
+    uint64_t instance = 0; // instanceFingerprint of the instance it solves
+    int generation = 0;
+    Population population;
+    std::vector<size_t> heap; // steady-state: WorstHeap::slots(); empty for generational runs
+};
+
+// Hash of the parameters a resumed run must share with the checkpointed one: everything except
+// the number of generations, the initial seeding and the parallel grain
+uint64_t settingsFingerprint(const GAParameters &params);
+
+// Throws std::runtime_error (with the path) if the file is missing, truncated, corrupt or of
+// another format version
+Checkpoint loadCheckpoint(const std::string &path);
+
+// Throws std::invalid_argument if `checkpoint` was not written by a run of `params` on `instance`
+void checkResumable(const Checkpoint &checkpoint, const GAParameters &params, const Instance &instance);
+
+// Writes `path`.tmp, syncs it, renames it over `path` and syncs the directory, so `path` always holds a complete
+// checkpoint, the previous one if the writer is interrupted. Throws std::runtime_error on I/O errors.
+void saveCheckpoint(const std::string &path, const Checkpoint &checkpoint);
+
+// Periodic checkpoints that keep the file I/O off the GA thread: offer() only copies the population
+// into a buffer and a background thread encodes and saves it. If the writer is still busy with the
+// previous checkpoint, the new one is skipped rather than waited for.
+class Checkpointer {
+public:
+    // Checkpoint to `path` every `interval` generations (no checkpoints for an empty path); with
+    // `resume` the run starts from that checkpoint instead of a new population
+    Checkpointer(std::string path, int interval, std::unique_ptr<Checkpoint> resume = nullptr);
+    ~Checkpointer();
+
+    Checkpointer(const Checkpointer &) = delete;
+    Checkpointer &operator=(const Checkpointer &) = delete;
+
+    const Checkpoint *resumeFrom() const { return resume.get(); }
+
+    bool due(int generation) const { return !path.empty() && generation % interval == 0; }
+
+    // Hand over the state after `generation`; with `wait` (the end of a run) the checkpoint is
+    // never skipped. Rethrows the error of a failed earlier write.
+    void offer(const GAParameters &params, const Instance &instance, int generation, const Population &population,
+               const WorstHeap *heap, bool wait = false);
+
+    // Wait for the pending write; rethrows its error
+    void finish();
+
+    int written() const { return writes; }
+    int skipped() const { return skips; }
+
+private:
+    std::string path;
+    int interval;
+    std::unique_ptr<Checkpoint> resume;
+    Checkpoint pending;
+    bool busy = false;
+    bool done = false;
+    int writes = 0;
+    int skips = 0;
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread writer;
+
+    void run();
+};
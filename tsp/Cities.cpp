@@ -0,0 +1,70 @@
+#include "tsp/Cities.h"
+
+#include "common/Random.h"
+
+std::vector<City> defaultCities() {
+    return {
+            {60,  200},
+            {180, 200},
+            {80,  180},
+            {140, 180},
+            {20,  160},
+            {100, 160},
+            {200, 160},
+            {140, 140},
+            {40,  120},
+            {100, 120},
+            {20,  100},
+            {60,  100},
+            {120, 100},
+            {160, 100},
+            {200, 100},
+            {20,  80},
+            {60,  80},
+            {120, 80},
+            {160, 80},
+            {200, 80},
+            {20,  60},
+            {60,  60},
+            {120, 60},
+            {160, 60},
+            {200, 60},
+            {20,  40},
+            {60,  40},
+            {120, 40},
+            {160, 40},
+            {200, 40},
+            {20,  20},
+            {60,  20},
+            {120, 20},
+            {160, 20},
+            {200, 20},
+            {40,  140},
+            {80,  140},
+            {120, 140},
+            {160, 140},
+            {40,  120},
+            {80,  120},
+            {120, 120},
+            {160, 120},
+            {200, 10},
+            {140, 50},
+            {160, 50},
+            {50, 120},
+            {10, 120},
+            {40, 10},
+            {160, 10},
+    };
+}
+
+std::vector<City> randomCities(size_t n, uint64_t seed, int extent) {
+    Rng rng(seed);
+    std::vector<City> cities;
+    cities.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        double x = rng.below(extent);
+        double y = rng.below(extent);
+        cities.emplace_back(x, y);
+    }
+    return cities;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "tsp/City.h"
+
+// The 50-city benchmark instance shared by all TSP drivers
+std::vector<City> defaultCities();
+
+// n cities with integer coordinates drawn uniformly from [0, extent), reproducible from the seed
+std::vector<City> randomCities(size_t n, uint64_t seed, int extent = 1000000);
@@ -0,0 +1,14 @@
+#pragma once
+
+// Class to represent a city with its x and y coordinates
+class City {
+public:
+    double x, y;
+
+    City(double x, double y) : x(x), y(y) {}
+
+    // Overload the equality operator for comparison
+    bool operator==(const City &other) const {
+        return x == other.x && y == other.y;
+    }
+};
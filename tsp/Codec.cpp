@@ -0,0 +1,12 @@
+#include "tsp/Codec.h"
+
+#include <numeric>
+
+uint64_t instanceFingerprint(const Instance &instance) {
+    std::vector<CityId> identity(instance.size());
+    std::iota(identity.begin(), identity.end(), CityId(0));
+    Fnv fnv;
+    fnv.add(static_cast<uint64_t>(instance.size()));
+    fnv.add(instance.distances.tourLength(identity.data(), identity.size()));
+    return fnv.value();
+}
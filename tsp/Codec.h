@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "tsp/Instance.h"
+#include "tsp/Route.h"
+
+// Binary encoding shared by checkpoint files (tsp/Checkpoint.h) and migrant frames
+// (tsp/MigrationNode.h): little-endian integers and doubles, and city orders as a bit stream of ids
+// just wide enough for the instance (17 bits per city for 100k cities instead of 32).
+
+// FNV-1a, for fingerprints and checksums
+class Fnv {
+public:
+    void add(const void *data, size_t size) {
+        const auto *bytes = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+        }
+    }
+
+    template<typename T>
+    void add(T value) { add(&value, sizeof(value)); }
+
+    uint64_t value() const { return hash; }
+
+private:
+    uint64_t hash = 0xcbf29ce484222325ull;
+};
+
+// Hash of the number of cities and the length of the identity tour, which tells whether two
+// processes or a file and a run refer to the same instance
+uint64_t instanceFingerprint(const Instance &instance);
+
+// Bits needed for the ids 0..n-1
+inline int cityIdWidth(size_t n) {
+    int width = 1;
+    while (width < 32 && (uint64_t(1) << width) < n) ++width;
+    return width;
+}
+
+// Appends little-endian fields and a bit stream of city ids to a byte buffer
+class ByteEncoder {
+public:
+    explicit ByteEncoder(std::vector<unsigned char> &out) : out(out) {}
+
+    void bytes(const void *data, size_t size) {
+        const auto *p = static_cast<const unsigned char *>(data);
+        out.insert(out.end(), p, p + size);
+    }
+
+    void u32(uint32_t value) {
+        for (int b = 0; b < 4; ++b) out.push_back(static_cast<unsigned char>(value >> (8 * b)));
+    }
+
+    void u64(uint64_t value) {
+        for (int b = 0; b < 8; ++b) out.push_back(static_cast<unsigned char>(value >> (8 * b)));
+    }
+
+    void f64(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        u64(bits);
+    }
+
+    void ids(const CityId *order, size_t n, int width) {
+        for (size_t i = 0; i < n; ++i) {
+            pending |= static_cast<uint64_t>(order[i]) << filled;
+            filled += width;
+            while (filled >= 8) {
+                out.push_back(static_cast<unsigned char>(pending));
+                pending >>= 8;
+                filled -= 8;
+            }
+        }
+    }
+
+    // Pads the bit stream to a whole byte
+    void flushIds() {
+        if (filled > 0) out.push_back(static_cast<unsigned char>(pending));
+        pending = 0;
+        filled = 0;
+    }
+
+private:
+    std::vector<unsigned char> &out;
+    uint64_t pending = 0;
+    int filled = 0;
+};
+
+// Reads what ByteEncoder wrote. Errors throw std::runtime_error prefixed with `source` (a file
+// name or a peer address), as does truncated input.
+class ByteDecoder {
+public:
+    ByteDecoder(const std::string &source, const unsigned char *p, const unsigned char *end)
+            : source(source), p(p), end(end) {}
+
+    [[noreturn]] void fail(const std::string &message) const {
+        throw std::runtime_error(source + ": " + message);
+    }
+
+    void bytes(void *data, size_t size) {
+        need(size);
+        std::memcpy(data, p, size);
+        p += size;
+    }
+
+    uint32_t u32() {
+        need(4);
+        uint32_t value = 0;
+        for (int b = 0; b < 4; ++b) value |= static_cast<uint32_t>(*p++) << (8 * b);
+        return value;
+    }
+
+    uint64_t u64() {
+        need(8);
+        uint64_t value = 0;
+        for (int b = 0; b < 8; ++b) value |= static_cast<uint64_t>(*p++) << (8 * b);
+        return value;
+    }
+
+    double f64() {
+        uint64_t bits = u64();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    void ids(CityId *order, size_t n, int width) {
+        uint64_t mask = (uint64_t(1) << width) - 1;
+        for (size_t i = 0; i < n; ++i) {
+            while (filled < width) {
+                need(1);
+                pending |= static_cast<uint64_t>(*p++) << filled;
+                filled += 8;
+            }
+            uint64_t id = pending & mask;
+            if (id >= n) fail("city id out of range");
+            order[i] = static_cast<CityId>(id);
+            pending >>= width;
+            filled -= width;
+        }
+    }
+
+    void skipIdPadding() {
+        pending = 0;
+        filled = 0;
+    }
+
+    const unsigned char *position() const { return p; }
+
+private:
+    const std::string &source;
+    const unsigned char *p;
+    const unsigned char *end;
+    uint64_t pending = 0;
+    int filled = 0;
+
+    void need(size_t size) const {
+        if (static_cast<size_t>(end - p) < size) fail("truncated data");
+    }
+};
@@ -0,0 +1,196 @@
+#include "tsp/Crossover.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Per-thread working memory of the operators; vectors only ever grow, so after the first call on
+// the largest instance they are reused without allocating
+struct CrossoverScratch {
+    std::vector<uint8_t> mark;        // city (OX) or position (CX) already placed
+    std::vector<CityId> neighbours;   // ERX edge lists, four slots per city
+    std::vector<uint8_t> shared;      // ERX: whether the edge in the same slot is in both parents
+    std::vector<uint8_t> degree;      // ERX: number of edges left in each city's list
+    std::vector<CityId> unvisited;    // ERX: cities not yet in the child, in no particular order
+    std::vector<CityId> slot;         // ERX: index of each city in `unvisited`
+};
+
+CrossoverScratch &scratch() {
+    static thread_local CrossoverScratch buffers;
+    return buffers;
+}
+
+// Random segment [start, end] of a route of n cities
+std::pair<size_t, size_t> randomSegment(size_t n, Rng &rng) {
+    size_t start = rng.below(n);
+    size_t end = rng.below(n);
+    if (start > end) std::swap(start, end);
+    return {start, end};
+}
+
+// Add the undirected edge (a, b) to a's list, flagging it as shared if the other parent had it too
+void addEdge(CrossoverScratch &s, CityId a, CityId b) {
+    CityId *list = &s.neighbours[size_t(a) * 4];
+    for (uint8_t k = 0; k < s.degree[a]; ++k) {
+        if (list[k] == b) {
+            s.shared[size_t(a) * 4 + k] = 1;
+            return;
+        }
+    }
+    list[s.degree[a]] = b;
+    s.shared[size_t(a) * 4 + s.degree[a]] = 0;
+    ++s.degree[a];
+}
+
+void removeEdge(CrossoverScratch &s, CityId a, CityId b) {
+    CityId *list = &s.neighbours[size_t(a) * 4];
+    for (uint8_t k = 0; k < s.degree[a]; ++k) {
+        if (list[k] == b) {
+            uint8_t last = --s.degree[a];
+            list[k] = list[last];
+            s.shared[size_t(a) * 4 + k] = s.shared[size_t(a) * 4 + last];
+            return;
+        }
+    }
+}
+
+} // namespace
+
+CrossoverType parseCrossoverType(const std::string &name) {
+    if (name == "pmx") return CrossoverType::PartiallyMapped;
+    if (name == "ox") return CrossoverType::Order;
+    if (name == "cx") return CrossoverType::Cycle;
+    if (name == "erx") return CrossoverType::EdgeRecombination;
+    throw std::invalid_argument("unknown crossover '" + name + "' (expected pmx, ox, cx or erx)");
+}
+
+const char *crossoverTypeName(CrossoverType type) {
+    switch (type) {
+        case CrossoverType::PartiallyMapped:
+            return "pmx";
+        case CrossoverType::Order:
+            return "ox";
+        case CrossoverType::Cycle:
+            return "cx";
+        case CrossoverType::EdgeRecombination:
+            return "erx";
+    }
+    return "unknown";
+}
+
+void partiallyMappedCrossover(ConstRouteView parent1, ConstRouteView parent2, RouteView child, Rng &rng) {
+    // Start the child route as a copy of parent1 and swap the cities of a random segment of parent2
+    // into place; the inverse permutation finds each city in O(1)
+    child.assign(parent1);
+    auto [start, end] = randomSegment(child.size(), rng);
+    for (size_t i = start; i <= end; ++i) {
+        child.swapPositions(i, child.positionOf(parent2[i]));
+    }
+}
+
+void orderCrossover(ConstRouteView parent1, ConstRouteView parent2, RouteView child, Rng &rng) {
+    size_t n = child.size();
+    std::vector<uint8_t> &placed = scratch().mark;
+    placed.assign(n, 0);
+    auto [start, end] = randomSegment(n, rng);
+    for (size_t i = start; i <= end; ++i) {
+        child.order[i] = parent1[i];
+        placed[parent1[i]] = 1;
+    }
+    // Fill the positions after the segment (wrapping around) with the missing cities in the order
+    // they appear in parent2, also starting after the segment
+    size_t out = end + 1 == n ? 0 : end + 1;
+    size_t in = out;
+    for (size_t k = 0; k < n; ++k) {
+        CityId city = parent2[in];
+        if (!placed[city]) {
+            child.order[out] = city;
+            out = out + 1 == n ? 0 : out + 1;
+        }
+        in = in + 1 == n ? 0 : in + 1;
+    }
+    child.rebuildPositions();
+}
+
+void cycleCrossover(ConstRouteView parent1, ConstRouteView parent2, RouteView child, Rng &rng) {
+    size_t n = child.size();
+    std::vector<uint8_t> &visited = scratch().mark;
+    visited.assign(n, 0);
+    // Positions fall into cycles (i -> where parent1 has parent2[i]); each cycle is copied whole from
+    // one parent, alternating, which keeps the child a permutation. The first cycle's parent is random.
+    bool fromFirst = rng() & 1;
+    for (size_t startPos = 0; startPos < n; ++startPos) {
+        if (visited[startPos]) continue;
+        size_t i = startPos;
+        do {
+            visited[i] = 1;
+            child.order[i] = fromFirst ? parent1[i] : parent2[i];
+            i = parent1.positionOf(parent2[i]);
+        } while (i != startPos);
+        fromFirst = !fromFirst;
+    }
+    child.rebuildPositions();
+}
+
+void edgeRecombination(ConstRouteView parent1, ConstRouteView parent2, RouteView child, Rng &rng) {
+    size_t n = child.size();
+    if (n < 4) {
+        child.assign(parent1); // every tour of three cities or fewer is the same cycle
+        return;
+    }
+    CrossoverScratch &s = scratch();
+    if (s.neighbours.size() < 4 * n) {
+        s.neighbours.resize(4 * n);
+        s.shared.resize(4 * n);
+    }
+    s.degree.assign(n, 0);
+    s.unvisited.resize(n);
+    s.slot.resize(n);
+
+    // Edge table: the (up to four) neighbours of every city in either parent
+    for (ConstRouteView parent: {parent1, parent2}) {
+        for (size_t i = 0; i < n; ++i) {
+            CityId city = parent[i];
+            addEdge(s, city, parent[i == 0 ? n - 1 : i - 1]);
+            addEdge(s, city, parent[i + 1 == n ? 0 : i + 1]);
+        }
+    }
+    for (size_t c = 0; c < n; ++c) {
+        s.unvisited[c] = static_cast<CityId>(c);
+        s.slot[c] = static_cast<CityId>(c);
+    }
+
+    size_t remaining = n;
+    CityId current = static_cast<CityId>(rng.below(n));
+    for (size_t k = 0;; ++k) {
+        child.order[k] = current;
+        // Take the city out of the unvisited set and out of its neighbours' edge lists
+        CityId moved = s.unvisited[--remaining];
+        s.unvisited[s.slot[current]] = moved;
+        s.slot[moved] = s.slot[current];
+        const CityId *list = &s.neighbours[size_t(current) * 4];
+        for (uint8_t e = 0; e < s.degree[current]; ++e) {
+            removeEdge(s, list[e], current);
+        }
+        if (k + 1 == n) break;
+
+        // Continue along an edge of the parents: a shared one if possible, otherwise towards the
+        // neighbour with the fewest edges left, which is the likeliest to be stranded later
+        int best = -1;
+        for (uint8_t e = 0; e < s.degree[current]; ++e) {
+            if (best < 0) {
+                best = e;
+                continue;
+            }
+            uint8_t sharedE = s.shared[size_t(current) * 4 + e], sharedBest = s.shared[size_t(current) * 4 + best];
+            if (sharedE > sharedBest || (sharedE == sharedBest && s.degree[list[e]] < s.degree[list[best]])) {
+                best = e;
+            }
+        }
+        current = best >= 0 ? list[best] : s.unvisited[rng.below(remaining)];
+    }
+    child.rebuildPositions();
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+
+#include "common/Random.h"
+#include "tsp/Route.h"
+
+// Recombination operators on city orders. Each one writes a complete child permutation (order and
+// positions) into `child` from two parents of the same size in O(n) time; the child's length is left
+// stale. Bookkeeping lives in per-thread scratch buffers that are reused across calls, so no operator
+// allocates once a thread has seen the largest instance.
+
+enum class CrossoverType {
+    PartiallyMapped,   // PMX: the child is parent1 with a random segment of parent2 swapped into place
+    Order,             // OX: a segment of parent1, the remaining cities in parent2's order after it
+    Cycle,             // CX: every position comes from one of the parents, alternating by cycle
+    EdgeRecombination  // ERX: the child is built from edges of either parent, preferring shared ones
+};
+
+// Parse "pmx", "ox", "cx" or "erx"; throws on anything else
+CrossoverType parseCrossoverType(const std::string &name);
+const char *crossoverTypeName(CrossoverType type);
+
+void partiallyMappedCrossover(ConstRouteView parent1, ConstRouteView parent2, RouteView child, Rng &rng);
+void orderCrossover(ConstRouteView parent1, ConstRouteView parent2, RouteView child, Rng &rng);
+void cycleCrossover(ConstRouteView parent1, ConstRouteView parent2, RouteView child, Rng &rng);
+void edgeRecombination(ConstRouteView parent1, ConstRouteView parent2, RouteView child, Rng &rng);
+
+inline void recombine(CrossoverType type, ConstRouteView parent1, ConstRouteView parent2, RouteView child,
+                      Rng &rng) {
+    switch (type) {
+        case CrossoverType::PartiallyMapped:
+            partiallyMappedCrossover(parent1, parent2, child, rng);
+            break;
+        case CrossoverType::Order:
+            orderCrossover(parent1, parent2, child, rng);
+            break;
+        case CrossoverType::Cycle:
+            cycleCrossover(parent1, parent2, child, rng);
+            break;
+        case CrossoverType::EdgeRecombination:
+            edgeRecombination(parent1, parent2, child, rng);
+            break;
+    }
+}
@@ -0,0 +1,40 @@
+#include "tsp/DistanceTable.h"
+
+#include <utility>
+
+// TSPLIB converts GEO coordinates (DDD.MM, degrees and minutes) to radians with PI = 3.141592
+static double geoRadians(double coordinate) {
+    const double PI = 3.141592;
+    double degrees = static_cast<double>(static_cast<long>(coordinate));
+    double minutes = coordinate - degrees;
+    return PI * (degrees + 5.0 * minutes / 3.0) / 180.0;
+}
+
+DistanceTable::DistanceTable(const std::vector<City> &cities, Metric metric) : n(cities.size()), kind(metric) {
+    x.resize(n);
+    y.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = metric == Metric::Geo ? geoRadians(cities[i].x) : cities[i].x;
+        y[i] = metric == Metric::Geo ? geoRadians(cities[i].y) : cities[i].y;
+    }
+    if (n > DENSE_LIMIT) {
+        return;
+    }
+    matrix.resize(n * n);
+    for (size_t i = 0; i < n; ++i) {
+        matrix[i * n + i] = 0.0f;
+        for (size_t j = i + 1; j < n; ++j) {
+            float d = compute(i, j);
+            matrix[i * n + j] = d;
+            matrix[j * n + i] = d;
+        }
+    }
+}
+
+DistanceTable DistanceTable::explicitMatrix(size_t n, std::vector<float> matrix) {
+    DistanceTable table;
+    table.n = n;
+    table.kind = Metric::Explicit;
+    table.matrix = std::move(matrix);
+    return table;
+}
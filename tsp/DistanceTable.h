@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "tsp/City.h"
+
+// How the distance between two cities is defined. Apart from Euclidean these are the TSPLIB
+// EDGE_WEIGHT_TYPEs, which round distances to integers in type-specific ways.
+enum class Metric {
+    Euclidean, // exact Euclidean distance (hard-coded and CSV instances)
+    Euc2D,     // EUC_2D: Euclidean rounded to the nearest integer
+    Ceil2D,    // CEIL_2D: Euclidean rounded up
+    Att,       // ATT: pseudo-Euclidean distance of the att48/att532 instances
+    Geo,       // GEO: geographical distance on an idealized sphere, coordinates as DDD.MM
+    Explicit   // EXPLICIT: distances given as a matrix
+};
+
+// Instance-level table of city-to-city distances read by the fitness path.
+// Up to DENSE_LIMIT cities every distance is precomputed into a dense float matrix,
+// so a lookup is a single load. Beyond that the n^2 matrix no longer fits in memory
+// and distances are computed on the fly by the metric's formula from coordinates kept in
+// structure-of-arrays form (one multiply-add and a sqrt for the Euclidean metrics, no std::hypot).
+// Explicit matrices are always stored densely.
+class DistanceTable {
+public:
+    // 4096^2 floats = 64 MiB
+    static const size_t DENSE_LIMIT = 4096;
+
+    DistanceTable() = default;
+    explicit DistanceTable(const std::vector<City> &cities, Metric metric = Metric::Euclidean);
+
+    // Table of an EXPLICIT instance: `matrix` is the full n x n row-major matrix
+    static DistanceTable explicitMatrix(size_t n, std::vector<float> matrix);
+
+    size_t size() const { return n; }
+    Metric metric() const { return kind; }
+    bool isDense() const { return !matrix.empty(); }
+
+    // Raw storage for the vectorized kernels of tsp/TourBatch.h: the n x n matrix when dense, and
+    // the coordinates (empty for explicit matrices)
+    const float *matrixData() const { return matrix.data(); }
+    const double *xData() const { return x.data(); }
+    const double *yData() const { return y.data(); }
+
+    float operator()(size_t from, size_t to) const {
+        if (isDense()) {
+            return matrix[from * n + to];
+        }
+        return compute(from, to);
+    }
+
+    // Distance by the metric's formula, bypassing the matrix
+    float compute(size_t from, size_t to) const {
+        double dx = x[from] - x[to];
+        double dy = y[from] - y[to];
+        switch (kind) {
+            case Metric::Euclidean:
+                return static_cast<float>(std::sqrt(dx * dx + dy * dy));
+            case Metric::Euc2D:
+                return static_cast<float>(static_cast<long>(std::sqrt(dx * dx + dy * dy) + 0.5));
+            case Metric::Ceil2D:
+                return static_cast<float>(std::ceil(std::sqrt(dx * dx + dy * dy)));
+            case Metric::Att: {
+                double r = std::sqrt((dx * dx + dy * dy) / 10.0);
+                double t = static_cast<double>(static_cast<long>(r + 0.5));
+                return static_cast<float>(t < r ? t + 1.0 : t);
+            }
+            case Metric::Geo: {
+                // x and y hold latitude and longitude in radians
+                const double RRR = 6378.388;
+                double q1 = std::cos(y[from] - y[to]);
+                double q2 = std::cos(x[from] - x[to]);
+                double q3 = std::cos(x[from] + x[to]);
+                return static_cast<float>(
+                        static_cast<long>(RRR * std::acos(0.5 * ((1.0 + q1) * q2 - (1.0 - q1) * q3)) + 1.0));
+            }
+            case Metric::Explicit:
+                break;
+        }
+        return matrix[from * n + to];
+    }
+
+    // Tour lengths are summed in blocks of this many edges, always combined in block order,
+    // so a tour split across threads block by block sums to exactly the serial result
+    static const size_t TOUR_BLOCK = 4096;
+
+    static size_t tourBlocks(size_t n) { return (n + TOUR_BLOCK - 1) / TOUR_BLOCK; }
+
+    // Sum of the edges ending at positions [b * TOUR_BLOCK, (b + 1) * TOUR_BLOCK) of a closed tour;
+    // block 0 starts with the closing edge from the last city back to the first
+    template<typename Index>
+    double blockLength(const Index *order, size_t n, size_t b) const {
+        size_t begin = b * TOUR_BLOCK, end = std::min(n, begin + TOUR_BLOCK);
+        double length = 0.0;
+        if (begin == 0) {
+            length = (*this)(order[n - 1], order[0]);
+            begin = 1;
+        }
+        for (size_t i = begin; i < end; ++i) {
+            length += (*this)(order[i - 1], order[i]);
+        }
+        return length;
+    }
+
+    // Length of the closed tour visiting the given city indices in order
+    template<typename Index>
+    double tourLength(const Index *order, size_t n) const {
+        double length = 0.0;
+        for (size_t b = 0; b < tourBlocks(n); ++b) {
+            length += blockLength(order, n, b);
+        }
+        return length;
+    }
+
+private:
+    size_t n = 0;
+    Metric kind = Metric::Euclidean;
+    std::vector<double> x, y;
+    std::vector<float> matrix;
+};
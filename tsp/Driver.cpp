@@ -0,0 +1,217 @@
+#include "tsp/Driver.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <omp.h>
+
+#include "common/Profiler.h"
+#include "common/Reporter.h"
+#include "tsp/Checkpoint.h"
+#include "tsp/Cities.h"
+#include "tsp/InstanceLoader.h"
+#include "tsp/IslandModel.h"
+#include "tsp/MigrationNode.h"
+#include "tsp/TourBatch.h"
+
+void applyGASettings(const Config &config, GAParameters &params) {
+    if (config.has("seeding")) params.seeding = parseTourSeeding(config.getString("seeding", ""));
+    params.mutationRate = static_cast<float>(config.getDouble("mutation-rate", params.mutationRate));
+    params.crossoverRate = static_cast<float>(config.getDouble("crossover-rate", params.crossoverRate));
+    if (config.has("replacement")) params.replacement = parseReplacement(config.getString("replacement", ""));
+    params.elites = static_cast<int>(config.getInt("elites", params.elites));
+    if (config.has("crossover")) params.crossover = parseCrossoverType(config.getString("crossover", ""));
+    if (config.has("mutation-move")) params.mutationMove = parseMoveType(config.getString("mutation-move", ""));
+    if (config.has("grain")) params.grain = parseParallelGrain(config.getString("grain", ""));
+    params.localSearch = config.getBool("local-search", params.localSearch);
+    params.candidates = static_cast<int>(config.getInt("candidates", params.candidates));
+    params.islands = static_cast<int>(config.getInt("islands", params.islands));
+    params.migrationInterval = static_cast<int>(config.getInt("migration-interval", params.migrationInterval));
+    params.migrants = static_cast<int>(config.getInt("migrants", params.migrants));
+    if (config.has("simd")) selectTourBatchKernel(config.getString("simd", ""));
+}
+
+int runTspDriver(int argc, char **argv, ExecutionPolicy defaultPolicy) {
+    ExecutionPolicy policy = defaultPolicy;
+    GAParameters params;
+    std::string instancePath, tourPath, checkpointPath, resumePath;
+    int checkpointEvery = 100;
+    int profileEvery = 0;
+    bool seedGiven = false;
+    ReportOptions reportOptions;
+    StopCriteria stopCriteria;
+    NodeOptions nodeOptions;
+    try {
+        Config config = Config::fromCommandLine(argc, argv);
+        for (const std::string &word: config.positional()) {
+            policy = parseExecutionPolicy(word);
+        }
+        if (config.has("policy")) policy = parseExecutionPolicy(config.getString("policy", ""));
+        seedGiven = config.has("seed");
+        params.seed = config.getUint64("seed", std::random_device{}());
+        params.populationSize = static_cast<int>(config.getInt("population", params.populationSize));
+        params.numGenerations = static_cast<int>(config.getInt("generations", params.numGenerations));
+        applyGASettings(config, params);
+        if (params.populationSize < 1 || params.numGenerations < 0) {
+            throw std::invalid_argument("--population must be at least 1 and --generations not negative");
+        }
+        if (config.has("threads")) {
+            long threads = config.getInt("threads", 1);
+            if (threads < 1) throw std::invalid_argument("--threads must be at least 1");
+            omp_set_num_threads(static_cast<int>(threads));
+        }
+        instancePath = config.getString("instance", "");
+        tourPath = config.getString("tour", "");
+        reportOptions = reportOptionsFromConfig(config);
+        stopCriteria = stopCriteriaFromConfig(config);
+        checkpointPath = config.getString("checkpoint", "");
+        checkpointEvery = static_cast<int>(config.getInt("checkpoint-every", checkpointEvery));
+        resumePath = config.getString("resume", "");
+        profileEvery = profileIntervalFromConfig(config);
+        nodeOptions.peers = config.getList("peers", {});
+        nodeOptions.rank = static_cast<int>(config.getInt("rank", nodeOptions.rank));
+        if (config.has("topology")) nodeOptions.topology = parseMigrationTopology(config.getString("topology", ""));
+        nodeOptions.connectTimeout = config.getDouble("connect-timeout", nodeOptions.connectTimeout);
+        nodeOptions.seed = params.seed;
+        config.checkUnused();
+        bool checkpointing = !checkpointPath.empty() || !resumePath.empty();
+        if (checkpointing && (policy == ExecutionPolicy::Islands || policy == ExecutionPolicy::Async)) {
+            throw std::invalid_argument("checkpoints need the serial, omp or task policy");
+        }
+        if (checkpointEvery < 1) throw std::invalid_argument("--checkpoint-every must be at least 1");
+        if (!nodeOptions.peers.empty() && (policy != ExecutionPolicy::Islands || checkpointing)) {
+            throw std::invalid_argument("--peers needs the island policy and no checkpoints");
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    Instance instance;
+    std::vector<CityId> optimalTour;
+    std::unique_ptr<Checkpoint> resume;
+    std::unique_ptr<MigrationNode> node;
+    try {
+        auto loadStart = std::chrono::steady_clock::now();
+        instance = instancePath.empty() ? Instance(defaultCities(), "default50") : loadInstance(instancePath);
+        std::string suffix = ".tsp";
+        bool tsplib = instancePath.size() > suffix.size() &&
+                      instancePath.compare(instancePath.size() - suffix.size(), suffix.size(), suffix) == 0;
+        if (tourPath.empty() && tsplib) {
+            std::string candidate = instancePath.substr(0, instancePath.size() - suffix.size()) + ".opt.tour";
+            if (std::ifstream(candidate).good()) tourPath = candidate;
+        }
+        if (!tourPath.empty()) {
+            optimalTour = loadTour(tourPath, instance.size());
+        }
+        auto loadTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart);
+        if (!instancePath.empty()) {
+            std::cout << "Loaded " << instance.name << " (" << instance.size() << " cities) in "
+                      << loadTime.count() << " ms" << std::endl;
+        }
+        if (!resumePath.empty()) {
+            resume = std::make_unique<Checkpoint>(loadCheckpoint(resumePath));
+            if (!seedGiven) params.seed = resume->seed;
+            checkResumable(*resume, params, instance);
+            std::cout << "Resuming from generation " << resume->generation << " of " << resumePath << std::endl;
+        }
+        if (!nodeOptions.peers.empty()) {
+            // Waits for the nodes this one connects to
+            node = std::make_unique<MigrationNode>(nodeOptions, instance, std::max(1, 4 * params.migrants));
+            std::cout << "Node " << node->rank() << " of " << node->nodes() << " ("
+                      << migrationTopologyName(node->topology()) << " topology) on "
+                      << nodeOptions.peers[node->rank()] << std::endl;
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    // Starting the timer
+    auto start = std::chrono::high_resolution_clock::now();
+
+    Route bestRoute;
+    StopCondition stop(stopCriteria);
+    int lastGeneration = 0;
+    // Checkpoints are written by their own background thread
+    Checkpointer checkpoints(checkpointPath, checkpointEvery, std::move(resume));
+    {
+        // Generation reports are written by the reporter's background thread
+        Reporter reporter(reportOptions);
+        auto observer = [&](int generation, const Population &population) {
+            lastGeneration = generation;
+            if (reporter.wants(generation)) {
+                std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+                reporter.record({generation, elapsed.count(), population.length(population.bestIndex()),
+                                 population.meanLength(), population.diversity()});
+            }
+            if (reporter.wantsDump()) {
+                std::ostringstream dump;
+                dump << "Generation " << generation << ":\n";
+                for (size_t i = 0; i < population.size(); ++i) {
+                    dump << "  route " << i << ": " << population.length(i) << '\n';
+                }
+                reporter.dump(dump.str());
+            }
+            // On stderr, so it cannot interleave with the reporter's output
+            if (profileEvery > 0 && generation > 0 && generation % profileEvery == 0) {
+                std::cerr << "After generation " << generation << ": ";
+                writeProfileReport(std::cerr);
+            }
+        };
+        try {
+            if (node) {
+                bestRoute = runIslandModel(instance, params, observer, &stop, node.get());
+                // Node 0 reports the best route of all nodes
+                bestRoute = node->gatherBest(bestRoute);
+            } else {
+                bestRoute = runGeneticAlgorithm(instance, params, policy, observer, &stop, &checkpoints);
+            }
+            checkpoints.finish();
+        } catch (const std::exception &e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    // Print the best route and its total distance
+    printRoute(std::cout, instance, bestRoute);
+    if (!optimalTour.empty()) {
+        double optimum = instance.distances.tourLength(optimalTour.data(), optimalTour.size());
+        std::cout << "Optimal distance: " << optimum << " (gap "
+                  << 100.0 * (bestRoute.totalDistance() - optimum) / optimum << "%)" << std::endl;
+    }
+
+    // Ending the timer
+    auto end = std::chrono::high_resolution_clock::now();
+
+    // Calculating elapsed time in milliseconds
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+    // Print the elapsed time
+    std::cout << "Generations: " << lastGeneration << " (" << stopReasonName(stop.reason()) << ")" << std::endl;
+    std::cout << "Evaluations: " << stop.evaluationCount() << " ("
+              << (duration > 0 ? 1000.0 * stop.evaluationCount() / duration : 0.0) << "/s)" << std::endl;
+    std::cout << "Seed: " << params.seed << std::endl;
+    if (node) {
+        std::cout << "Migrants: " << node->sent() << " sent, " << node->received() << " received, "
+                  << node->dropped() << " dropped" << std::endl;
+    }
+    if (!checkpointPath.empty()) {
+        std::cout << "Checkpoints: " << checkpoints.written() << " written to " << checkpointPath << " ("
+                  << checkpoints.skipped() << " skipped while the writer was busy)" << std::endl;
+    }
+    std::cout << "Execution time: " << duration << " ms (" << executionPolicyName(policy) << ")" << std::endl;
+    writeProfileReport(std::cout);
+
+    return 0;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "common/Config.h"
+#include "tsp/GeneticAlgorithm.h"
+
+// Common main() body of the TSP drivers: solves an instance with the given policy and prints the
+// best route, the evaluation throughput, the seed and the execution time. Settings come from the
+// command line and from an optional config file (see common/Config.h), e.g.
+// "tls_omp --population 500 --threads 8" or "tls_omp --config sweep.cfg" with "population = 500" lines:
+//   serial|omp|task|island|async
+//                            override the driver's execution policy (also --policy NAME)
+//   --seed N                 reproduce an earlier run
+//   --instance FILE          TSPLIB .tsp or coordinate .csv file instead of the built-in 50 cities
+//   --tour FILE              known optimal tour to report the gap to (default: FILE.opt.tour
+//                            next to a .tsp instance, when it exists)
+//   --population N, --generations N
+//   --threads N              OpenMP threads (default: OMP_NUM_THREADS or all cores)
+//   --target LENGTH, --stagnation N, --time-limit SECONDS, --max-evaluations N
+//                            end the run early (see stopCriteriaFromConfig in common/StopCondition.h)
+//   --checkpoint FILE, --checkpoint-every N
+//                            save the run every N generations (default 100) and at its end
+//                            (serial, omp and task policies; see tsp/Checkpoint.h)
+//   --resume FILE            continue a checkpointed run bit for bit, with the same settings;
+//                            --generations is still the total count
+//   operator and island settings, see applyGASettings
+//   --peers ADDRESS,...      distributed island run: the listening address (HOST:PORT or
+//                            unix:PATH) of every process, the same list for all of them; with the
+//                            island policy only, and --population is the population of each process
+//   --rank N                 index of this process in --peers (default 0); node 0 prints the best
+//                            route of all nodes
+//   --topology ring|star|random, --connect-timeout SECONDS
+//                            where a node sends its migrants, and how long it waits for the other
+//                            nodes to start (default 30; see tsp/MigrationNode.h)
+//   --profile-every N        with a GA_PROFILE build, which prints an operator profile at the end
+//                            of the run (see common/Profiler.h), also print one every N generations
+//   --report, --report-format, --report-file
+//                            per-generation statistics (see reportOptionsFromConfig in common/Reporter.h)
+int runTspDriver(int argc, char **argv, ExecutionPolicy defaultPolicy);
+
+// Read the operator and island settings shared by the drivers and tsp_bench into `params`:
+// seeding (random|nn|sfc|mixed), replacement (generational|steady), elites, mutation-rate,
+// crossover-rate, crossover (pmx|ox|cx|erx), mutation-move (swap|insertion|2opt),
+// grain (auto|population|tour), local-search (true|false), candidates, islands, migration-interval
+// and migrants. Unset keys keep the values already in `params`. Also applies simd
+// (auto|scalar|avx2|avx512), the process-wide kernel of batchTourLengths (see tsp/TourBatch.h).
+void applyGASettings(const Config &config, GAParameters &params);
@@ -0,0 +1,446 @@
+#include "tsp/GeneticAlgorithm.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <omp.h>
+
+#include "common/Profiler.h"
+#include "common/WorkStealingDeque.h"
+#include "tsp/AsyncEngine.h"
+#include "tsp/Checkpoint.h"
+#include "tsp/IslandModel.h"
+#include "tsp/TourBatch.h"
+
+ExecutionPolicy parseExecutionPolicy(const std::string &name) {
+    if (name == "serial") return ExecutionPolicy::Serial;
+    if (name == "omp") return ExecutionPolicy::ParallelFor;
+    if (name == "task") return ExecutionPolicy::Tasks;
+    if (name == "island") return ExecutionPolicy::Islands;
+    if (name == "async") return ExecutionPolicy::Async;
+    throw std::invalid_argument("unknown execution policy '" + name
+                                + "' (expected serial, omp, task, island or async)");
+}
+
+const char *executionPolicyName(ExecutionPolicy policy) {
+    switch (policy) {
+        case ExecutionPolicy::Serial:
+            return "serial";
+        case ExecutionPolicy::ParallelFor:
+            return "omp";
+        case ExecutionPolicy::Tasks:
+            return "task";
+        case ExecutionPolicy::Islands:
+            return "island";
+        case ExecutionPolicy::Async:
+            return "async";
+    }
+    return "unknown";
+}
+
+MoveType parseMoveType(const std::string &name) {
+    if (name == "swap") return MoveType::Swap;
+    if (name == "insertion") return MoveType::Insertion;
+    if (name == "2opt") return MoveType::TwoOpt;
+    throw std::invalid_argument("unknown move '" + name + "' (expected swap, insertion or 2opt)");
+}
+
+ParallelGrain parseParallelGrain(const std::string &name) {
+    if (name == "auto") return ParallelGrain::Auto;
+    if (name == "population") return ParallelGrain::Population;
+    if (name == "tour") return ParallelGrain::Tour;
+    throw std::invalid_argument("unknown grain '" + name + "' (expected auto, population or tour)");
+}
+
+Replacement parseReplacement(const std::string &name) {
+    if (name == "generational") return Replacement::Generational;
+    if (name == "steady") return Replacement::SteadyState;
+    throw std::invalid_argument("unknown replacement '" + name + "' (expected generational or steady)");
+}
+
+Population initializePopulation(const Instance &instance, const GAParameters &params, bool parallel) {
+    GA_PROFILE_ZONE(Initialization);
+    checkCityIdWidth(instance);
+    Population population(params.populationSize, instance.size());
+    TourSeeder seeder(instance, params.seeding);
+    // Tours are built TOUR_BATCH at a time and evaluated together by batchTourLengths
+    #pragma omp parallel for schedule(dynamic) if(parallel)
+    for (int batch = 0; batch < params.populationSize; batch += static_cast<int>(TOUR_BATCH)) {
+        int size = std::min(static_cast<int>(TOUR_BATCH), params.populationSize - batch);
+        const CityId *orders[TOUR_BATCH];
+        double lengths[TOUR_BATCH];
+        for (int k = 0; k < size; ++k) {
+            RouteView route = population.route(batch + k);
+            Rng rng = childRng(params, 0, batch + k);
+            seeder.build(route, static_cast<size_t>(batch + k), rng);
+            orders[k] = route.order;
+        }
+        batchTourLengths(instance.distances, orders, size, instance.size(), lengths);
+        for (int k = 0; k < size; ++k) {
+            *population.route(batch + k).length = lengths[k];
+        }
+    }
+    return population;
+}
+
+size_t tournamentSelection(const Population &population, Rng &rng) {
+    GA_PROFILE_ZONE(Selection);
+    // Select two random routes from the population
+    uint32_t index1 = rng.below(population.size());
+    uint32_t index2 = rng.below(population.size());
+    // Return the fittest of the two routes
+    return population.length(index1) < population.length(index2) ? index1 : index2;
+}
+
+ParallelGrain chooseParallelGrain(const GAParameters &params, size_t numCities, int numThreads) {
+    if (params.grain != ParallelGrain::Auto) {
+        return params.grain;
+    }
+    // Splitting a tour only pays off once every thread gets at least a couple of distance blocks,
+    // and is only needed when there are too few children to go around
+    bool fewChildren = params.populationSize < 2 * numThreads;
+    bool longTours = numCities >= 2 * DistanceTable::TOUR_BLOCK * static_cast<size_t>(numThreads);
+    return fewChildren && longTours ? ParallelGrain::Tour : ParallelGrain::Population;
+}
+
+bool crossoverOrder(ConstRouteView parent1, ConstRouteView parent2, RouteView child, float crossoverRate,
+                    CrossoverType type, Rng &rng) {
+    GA_PROFILE_ZONE(Crossover);
+    // With a certain probability, perform crossover between parent1 and parent2; otherwise the
+    // child is a copy of parent1
+    if (!rng.chance(crossoverRate)) {
+        child.assign(parent1);
+        return false;
+    }
+    recombine(type, parent1, parent2, child, rng);
+    return true;
+}
+
+void crossover(const Instance &instance, ConstRouteView parent1, ConstRouteView parent2, RouteView child,
+               float crossoverRate, CrossoverType type, Rng &rng) {
+    if (crossoverOrder(parent1, parent2, child, crossoverRate, type, rng)) {
+        child.calculateFitness(instance);
+    }
+}
+
+void mutate(const Instance &instance, RouteView route, float mutationRate, MoveType move, Rng &rng) {
+    GA_PROFILE_ZONE(Mutation);
+    // For each city in the route, with a certain probability, move it relative to another random city;
+    // each move only touches a handful of edges, so its O(1) delta keeps the length up to date
+    for (size_t i = 0; i < route.size(); ++i) {
+        if (rng.chance(mutationRate)) {
+            size_t index = rng.below(route.size());
+            applyMove(move, instance, route, i, index);
+        }
+    }
+}
+
+// Selection, crossover and mutation for the children [begin, end) of a generation, TOUR_BATCH at a
+// time: crossover runs for the whole batch first, so that the recombined children are evaluated
+// together by batchTourLengths, and mutation after that. Each child draws from its own random stream
+// throughout, so the results are those of building one child after another. The first parent of
+// child i, the reference of its local search, is written to parents[i - begin].
+static void buildChildren(const Instance &instance, const Population &population, Population &next,
+                          const GAParameters &params, int generation, int begin, int end, uint32_t *parents) {
+    for (int batch = begin; batch < end; batch += static_cast<int>(TOUR_BATCH)) {
+        int size = std::min(static_cast<int>(TOUR_BATCH), end - batch);
+        Rng rngs[TOUR_BATCH];
+        const CityId *stale[TOUR_BATCH];
+        double *staleLengths[TOUR_BATCH];
+        double lengths[TOUR_BATCH];
+        size_t numStale = 0;
+        for (int k = 0; k < size; ++k) {
+            RouteView child = next.route(batch + k);
+            rngs[k] = childRng(params, generation, batch + k);
+            size_t parent1 = tournamentSelection(population, rngs[k]);
+            size_t parent2 = tournamentSelection(population, rngs[k]);
+            parents[batch + k - begin] = static_cast<uint32_t>(parent1);
+            if (crossoverOrder(population.route(parent1), population.route(parent2), child, params.crossoverRate,
+                               params.crossover, rngs[k])) {
+                stale[numStale] = child.order;
+                staleLengths[numStale++] = child.length;
+            }
+        }
+        batchTourLengths(instance.distances, stale, numStale, instance.size(), lengths);
+        for (size_t s = 0; s < numStale; ++s) {
+            *staleLengths[s] = lengths[s];
+        }
+        for (int k = 0; k < size; ++k) {
+            mutate(instance, next.route(batch + k), params.mutationRate, params.mutationMove, rngs[k]);
+        }
+    }
+}
+
+// Whole children [begin, end), local search included; shared by the Serial and ParallelFor policies
+static void makeChildren(const Instance &instance, const Population &population, Population &next,
+                         const GAParameters &params, int generation, int begin, int end,
+                         const LocalSearch *localSearch) {
+    for (int batch = begin; batch < end; batch += static_cast<int>(TOUR_BATCH)) {
+        int batchEnd = std::min(end, batch + static_cast<int>(TOUR_BATCH));
+        uint32_t parents[TOUR_BATCH];
+        buildChildren(instance, population, next, params, generation, batch, batchEnd, parents);
+        for (int i = batch; localSearch && i < batchEnd; ++i) {
+            localSearch->improve(next.route(i), population.route(parents[i - batch]));
+        }
+    }
+}
+
+// Unit of work of the Tasks policy: the children [begin, end) of a generation or, with a negative
+// end, the local search of child `begin`
+struct ChildTask {
+    int32_t begin;
+    int32_t end;
+};
+
+// ExecutionPolicy::Tasks: every thread owns a work-stealing deque seeded with an equal share of the
+// children, and idle threads steal the oldest (largest) task of another thread. A thread halves its
+// current range, exposing the upper half, only while its own deque is empty, so ranges are cut just
+// as finely as idle threads demand (lazy binary splitting), but not below one batch of the tour
+// evaluation (TOUR_BATCH children). With a local search, the improvement of each child becomes a
+// task of its own, since its cost varies far more than that of crossover and mutation. Each child
+// is still built from its own random stream into its own slot.
+static void nextGenerationWorkStealing(const Instance &instance, const Population &population, Population &next,
+                                       const GAParameters &params, int generation, int first,
+                                       const LocalSearch *localSearch) {
+    int count = params.populationSize - first;
+    if (count <= 0) return;
+    // Deques of the team, reused across generations as long as they are large enough
+    using Deque = WorkStealingDeque<ChildTask>;
+    static thread_local std::vector<std::unique_ptr<Deque>> teamDeques;
+    size_t capacity = static_cast<size_t>(count) + 2;
+    size_t teamSize = static_cast<size_t>(omp_get_max_threads());
+    if (teamDeques.size() < teamSize || teamDeques.front()->capacity() < capacity) {
+        teamDeques.clear();
+        for (size_t t = 0; t < teamSize; ++t) {
+            teamDeques.push_back(std::make_unique<Deque>(capacity));
+        }
+    }
+    std::unique_ptr<Deque> *deques = teamDeques.data();
+    static thread_local std::vector<uint32_t> parents;
+    parents.resize(params.populationSize);
+    uint32_t *parentOf = parents.data();
+    std::atomic<int> remaining{count}; // children not finished yet, local search included
+
+    #pragma omp parallel default(none) shared(instance, population, next, params, generation, first, localSearch, count, deques, parentOf, remaining)
+    {
+        int self = omp_get_thread_num(), team = omp_get_num_threads();
+        Deque &own = *deques[self];
+        ChildTask share{first + static_cast<int>(int64_t(count) * self / team),
+                        first + static_cast<int>(int64_t(count) * (self + 1) / team)};
+        if (share.begin < share.end) own.tryPush(share);
+        #pragma omp barrier
+
+        auto finish = [&]() { remaining.fetch_sub(1, std::memory_order_release); };
+        auto improve = [&](int i) {
+            localSearch->improve(next.route(i), population.route(parentOf[i]));
+            finish();
+        };
+        int victim = self;
+        ChildTask task;
+        while (remaining.load(std::memory_order_acquire) > 0) {
+            bool found = own.tryPop(task);
+            for (int k = 1; !found && k < team; ++k) {
+                victim = (victim + 1) % team;
+                found = victim != self && deques[victim]->trySteal(task);
+            }
+            if (!found) {
+                std::this_thread::yield();
+                continue;
+            }
+            if (task.end < 0) {
+                improve(task.begin);
+                continue;
+            }
+            while (task.end - task.begin > static_cast<int>(TOUR_BATCH) && own.empty()) {
+                int middle = task.begin + (task.end - task.begin) / 2;
+                if (!own.tryPush({middle, task.end})) break;
+                task.end = middle;
+            }
+            buildChildren(instance, population, next, params, generation, task.begin, task.end,
+                          parentOf + task.begin);
+            for (int i = task.begin; i < task.end; ++i) {
+                if (!localSearch) {
+                    finish();
+                } else if (!own.tryPush({i, -1})) {
+                    improve(i);
+                }
+            }
+        }
+    }
+}
+
+// ParallelGrain::Tour: one team for the whole generation; a single thread does the sequential part
+// of each child while the team shares its tour-length evaluation. Block sums are combined in block
+// order, so the lengths are bit-identical to the serial ones.
+static void nextGenerationTourParallel(const Instance &instance, const Population &population, Population &next,
+                                       const GAParameters &params, int generation, int first,
+                                       const LocalSearch *localSearch) {
+    const DistanceTable &distances = instance.distances;
+    size_t n = instance.size();
+    size_t blocks = DistanceTable::tourBlocks(n);
+    static thread_local std::vector<double> blockLengths;
+    blockLengths.resize(blocks);
+    double *partial = blockLengths.data();
+    Rng rng;
+    size_t parent1 = 0;
+    bool stale = false;
+
+    #pragma omp parallel default(none) shared(instance, population, next, params, generation, first, localSearch, distances, n, blocks, partial, rng, parent1, stale)
+    for (int i = first; i < params.populationSize; ++i) {
+        RouteView child = next.route(i);
+        #pragma omp single
+        {
+            rng = childRng(params, generation, i);
+            parent1 = tournamentSelection(population, rng);
+            size_t parent2 = tournamentSelection(population, rng);
+            stale = crossoverOrder(population.route(parent1), population.route(parent2), child,
+                                   params.crossoverRate, params.crossover, rng);
+        }
+        if (stale) {
+            #pragma omp for schedule(static)
+            for (size_t b = 0; b < blocks; ++b) {
+                partial[b] = distances.blockLength(child.order, n, b);
+            }
+        }
+        #pragma omp single
+        {
+            if (stale) {
+                double length = 0.0;
+                for (size_t b = 0; b < blocks; ++b) {
+                    length += partial[b];
+                }
+                *child.length = length;
+            }
+            mutate(instance, child, params.mutationRate, params.mutationMove, rng);
+            if (localSearch) {
+                localSearch->improve(child, population.route(parent1));
+            }
+        }
+    }
+}
+
+// Copy the `count` shortest routes of `population` into the first slots of `next`
+static void copyElites(const Population &population, Population &next, int count) {
+    static thread_local std::vector<size_t> ranking;
+    ranking.resize(population.size());
+    std::iota(ranking.begin(), ranking.end(), 0);
+    std::nth_element(ranking.begin(), ranking.begin() + (count - 1), ranking.end(), [&](size_t a, size_t b) {
+        return population.length(a) < population.length(b);
+    });
+    for (int e = 0; e < count; ++e) {
+        next.route(e).assign(population.route(ranking[e]));
+    }
+}
+
+void nextGeneration(const Instance &instance, const Population &population, Population &next,
+                    const GAParameters &params, ExecutionPolicy policy, int generation,
+                    const LocalSearch *localSearch) {
+    // Children keep the random streams of their slots, so elitism does not change the other children
+    int first = 0;
+    if (params.replacement == Replacement::Generational && params.elites > 0) {
+        first = std::min(params.elites, params.populationSize);
+        copyElites(population, next, first);
+    }
+    switch (policy) {
+        case ExecutionPolicy::Serial:
+        case ExecutionPolicy::Islands: // each island evolves serially on its own thread
+        case ExecutionPolicy::Async:   // never run by generation; treated as serial
+            makeChildren(instance, population, next, params, generation, first, params.populationSize, localSearch);
+            break;
+        case ExecutionPolicy::ParallelFor:
+            if (chooseParallelGrain(params, instance.size(), omp_get_max_threads()) == ParallelGrain::Tour) {
+                nextGenerationTourParallel(instance, population, next, params, generation, first, localSearch);
+                break;
+            }
+            #pragma omp parallel for
+            for (int batch = first; batch < params.populationSize; batch += static_cast<int>(TOUR_BATCH)) {
+                int batchEnd = std::min(params.populationSize, batch + static_cast<int>(TOUR_BATCH));
+                makeChildren(instance, population, next, params, generation, batch, batchEnd, localSearch);
+            }
+            break;
+        case ExecutionPolicy::Tasks:
+            nextGenerationWorkStealing(instance, population, next, params, generation, first, localSearch);
+            break;
+    }
+}
+
+void replaceWorst(Population &population, const Population &children, WorstHeap &heap) {
+    GA_PROFILE_ZONE(Replacement);
+    for (size_t i = 0; i < children.size(); ++i) {
+        if (heap.improves(children.length(i))) {
+            population.route(heap.worst()).assign(children.route(i));
+            heap.replaceWorst(children.length(i));
+        }
+    }
+}
+
+Route runGeneticAlgorithm(const Instance &instance, const GAParameters &params, ExecutionPolicy policy,
+                          const GenerationObserver &observer, StopCondition *stop, Checkpointer *checkpoints) {
+    if (policy == ExecutionPolicy::Islands) {
+        return runIslandModel(instance, params, observer, stop);
+    }
+    if (policy == ExecutionPolicy::Async) {
+        return runAsyncSteadyState(instance, params, observer, stop);
+    }
+
+    // The current population (new, or that of the checkpoint to resume) and the buffer the next
+    // generation is written into
+    const Checkpoint *resume = checkpoints ? checkpoints->resumeFrom() : nullptr;
+    int start = resume ? resume->generation : 0;
+    Population population = resume ? resume->population
+                                   : initializePopulation(instance, params, policy != ExecutionPolicy::Serial);
+    Population next(params.populationSize, instance.size());
+    std::unique_ptr<LocalSearch> localSearch;
+    if (params.localSearch) {
+        localSearch = std::make_unique<LocalSearch>(instance, params.candidates);
+        if (!resume) improvePopulation(*localSearch, population, policy != ExecutionPolicy::Serial);
+    }
+    if (observer) observer(start, population);
+    if (stop) stop->addEvaluations(int64_t(params.populationSize) * (start + 1));
+
+    WorstHeap heap;
+    if (params.replacement == Replacement::SteadyState) {
+        auto length = [&](size_t i) { return population.length(i); };
+        if (resume) {
+            heap.restore(resume->heap, length, false);
+        } else {
+            heap.build(population.size(), length, false);
+        }
+    }
+    const WorstHeap *steadyHeap = params.replacement == Replacement::SteadyState ? &heap : nullptr;
+
+    // Loop through a set number of generations, then swap the buffers to replace the old population
+    // (or, steady-state, let the children displace the worst routes)
+    bool stopped = stop && stop->update(start, population.length(population.bestIndex()));
+    int generation = start;
+    while (generation < params.numGenerations && !stopped) {
+        ++generation;
+        nextGeneration(instance, population, next, params, policy, generation, localSearch.get());
+        if (params.replacement == Replacement::SteadyState) {
+            replaceWorst(population, next, heap);
+        } else {
+            population.swap(next);
+        }
+        if (observer) observer(generation, population);
+        if (stop) {
+            stop->addEvaluations(params.populationSize);
+            stopped = stop->update(generation, population.length(population.bestIndex()));
+        }
+        if (checkpoints && checkpoints->due(generation)) {
+            checkpoints->offer(params, instance, generation, population, steadyHeap);
+        }
+    }
+    // A final checkpoint, so that a finished or stopped run can be extended
+    if (checkpoints && generation > start) {
+        checkpoints->offer(params, instance, generation, population, steadyHeap, true);
+    }
+
+    // Find the best route in the final population
+    return Route(population.route(population.bestIndex()));
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "common/Random.h"
+#include "common/StopCondition.h"
+#include "common/WorstHeap.h"
+#include "tsp/Crossover.h"
+#include "tsp/Instance.h"
+#include "tsp/LocalSearch.h"
+#include "tsp/Moves.h"
+#include "tsp/Population.h"
+#include "tsp/Seeding.h"
+#include "tsp/Route.h"
+
+class Checkpointer; // tsp/Checkpoint.h
+
+// How the children of a generation are produced. Every policy runs the same operators;
+// only the scheduling of the per-child work differs.
+enum class ExecutionPolicy {
+    Serial,      // plain loop on the calling thread
+    ParallelFor, // OpenMP parallel for over the children
+    Tasks,       // chunks of children on work-stealing deques, one per OpenMP thread
+    Islands,     // one subpopulation per thread with periodic migration (see tsp/IslandModel.h)
+    Async        // lock-free steady state: threads replace routes of a shared population (see tsp/AsyncEngine.h)
+};
+
+// Level at which the ParallelFor policy parallelizes a generation. Only one level is ever active,
+// so no parallel region is opened inside another one.
+enum class ParallelGrain {
+    Auto,       // Population, unless the population is too small to occupy the team and the tours are long
+    Population, // children are distributed over the threads
+    Tour        // children are built one after another and each tour-length evaluation is split over the team
+};
+
+// How children enter the population
+enum class Replacement {
+    Generational, // the children replace the whole population, except for params.elites best routes
+    SteadyState   // every child replaces the current worst route if it is shorter (replace-worst)
+};
+
+// Parse "serial", "omp", "task", "island" or "async" (as used on the driver command lines); throws on anything else
+ExecutionPolicy parseExecutionPolicy(const std::string &name);
+const char *executionPolicyName(ExecutionPolicy policy);
+
+// Parse "swap", "insertion" or "2opt"; throws on anything else
+MoveType parseMoveType(const std::string &name);
+
+// Parse "auto", "population" or "tour"; throws on anything else
+ParallelGrain parseParallelGrain(const std::string &name);
+
+// Parse "generational" or "steady"; throws on anything else
+Replacement parseReplacement(const std::string &name);
+
+// Defaults of the drivers; every field can be overridden at run time (see tsp/Driver.h)
+struct GAParameters {
+    int populationSize = 100;
+    int numGenerations = 1000;
+    TourSeeding seeding = TourSeeding::Random;
+    float mutationRate = 0.1f;
+    float crossoverRate = 0.8f;
+    Replacement replacement = Replacement::Generational;
+    // Generational model: number of best routes copied unchanged into the next generation
+    int elites = 0;
+    CrossoverType crossover = CrossoverType::PartiallyMapped;
+    MoveType mutationMove = MoveType::Swap;
+    ParallelGrain grain = ParallelGrain::Auto;
+    // Memetic mode: improve the initial routes and every child with 2-opt and Or-opt over the
+    // `candidates` nearest neighbours of each city (see tsp/LocalSearch.h). Children are repaired
+    // starting from the cities crossover and mutation touched, so a low mutation rate keeps it cheap.
+    bool localSearch = false;
+    int candidates = 8;
+    // Island model: number of islands (0 = one per OpenMP thread), generations between migrations
+    // and number of best routes each island sends to its neighbour per migration.
+    // populationSize is split evenly across the islands.
+    int islands = 0;
+    int migrationInterval = 50;
+    int migrants = 2;
+    // Every random draw of a run derives from this seed, so a given seed reproduces the run
+    // bit for bit under every execution policy and thread count
+    uint64_t seed = 0;
+};
+
+// Random stream of the i-th child of a generation (generation 0 is the initial population).
+// Streams are keyed by counters rather than by thread, so results do not depend on scheduling.
+inline Rng childRng(const GAParameters &params, int generation, int i) {
+    return Rng::forStream(params.seed, static_cast<uint64_t>(generation), static_cast<uint64_t>(i));
+}
+
+// Function to initialize the population of routes as chosen by params.seeding; with `parallel` the
+// routes are built by an OpenMP loop (each from its own random stream, so the result is the same)
+Population initializePopulation(const Instance &instance, const GAParameters &params, bool parallel = false);
+
+// Function to perform tournament selection of routes; returns the index of the winner
+size_t tournamentSelection(const Population &population, Rng &rng);
+
+// Resolve ParallelGrain::Auto for a team of numThreads threads
+ParallelGrain chooseParallelGrain(const GAParameters &params, size_t numCities, int numThreads);
+
+// Crossover of the city orders only, with the given operator (see tsp/Crossover.h): writes the child
+// into `child` and returns true if its length is stale (crossover happened) and has to be recalculated
+bool crossoverOrder(ConstRouteView parent1, ConstRouteView parent2, RouteView child, float crossoverRate,
+                    CrossoverType type, Rng &rng);
+
+// Function to perform crossover between two routes, writing the result into `child`
+void crossover(const Instance &instance, ConstRouteView parent1, ConstRouteView parent2, RouteView child,
+               float crossoverRate, CrossoverType type, Rng &rng);
+
+// This function mutates a route by applying a random move (swapping two cities by default) at each
+// position with a given mutation rate. The route length is updated incrementally from the move deltas.
+void mutate(const Instance &instance, RouteView route, float mutationRate, MoveType move, Rng &rng);
+
+// Produce generation `generation` (counted from 1) from `population` into the preallocated buffer
+// `next`, using the given execution policy. Every child is written into its own slot of `next`.
+// With a local search every child is improved by it after mutation. In the generational model the
+// first params.elites slots receive copies of the best routes of `population` instead of children.
+void nextGeneration(const Instance &instance, const Population &population, Population &next,
+                    const GAParameters &params, ExecutionPolicy policy, int generation,
+                    const LocalSearch *localSearch = nullptr);
+
+// Steady-state replacement: insert every route of `children` into `population` in turn, each one
+// overwriting the current worst route if it is shorter. `heap` tracks the population's lengths
+// (built with WorstHeap::build over the population before the first call) and is kept up to date.
+void replaceWorst(Population &population, const Population &children, WorstHeap &heap);
+
+// Called after every generation (generation 0 being the initial population) with the current population
+using GenerationObserver = std::function<void(int generation, const Population &population)>;
+
+// Run the whole genetic algorithm and return the best route of the final population. With a stop
+// condition the run ends early as soon as it fires (checked after every generation with the
+// population's shortest tour); params.numGenerations remains the upper bound. With a checkpointer
+// the serial, omp and task policies resume from its checkpoint, if it has one, write checkpoints
+// at its interval and a last one when the run ends (see tsp/Checkpoint.h); the other policies
+// ignore it.
+Route runGeneticAlgorithm(const Instance &instance, const GAParameters &params, ExecutionPolicy policy,
+                          const GenerationObserver &observer = {}, StopCondition *stop = nullptr,
+                          Checkpointer *checkpoints = nullptr);
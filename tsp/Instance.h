@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "tsp/City.h"
+#include "tsp/DistanceTable.h"
+
+// A TSP instance: the cities to visit and the distances between them.
+// Routes refer to cities by their index into `cities`. Instances given as an explicit
+// distance matrix may have no coordinates, in which case `cities` is empty.
+class Instance {
+public:
+    std::string name;
+    std::vector<City> cities;
+    DistanceTable distances;
+
+    Instance() = default;
+    explicit Instance(std::vector<City> cities, std::string name = "", Metric metric = Metric::Euclidean)
+            : name(std::move(name)), cities(std::move(cities)), distances(this->cities, metric) {}
+    Instance(std::string name, DistanceTable distances)
+            : name(std::move(name)), distances(std::move(distances)) {}
+
+    size_t size() const { return distances.size(); }
+    bool hasCoordinates() const { return !cities.empty(); }
+};
@@ -0,0 +1,303 @@
+#include "tsp/InstanceLoader.h"
+
+#include <charconv>
+#include <map>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include "common/MappedFile.h"
+
+namespace {
+
+// Cursor over the mapped text of an instance file that keeps track of the line for error messages
+class Parser {
+public:
+    Parser(std::string path, std::string_view text)
+            : path(std::move(path)), p(text.data()), end(text.data() + text.size()) {}
+
+    bool atEnd() const { return p == end; }
+
+    [[noreturn]] void fail(const std::string &message) const {
+        throw std::runtime_error(path + ":" + std::to_string(line) + ": " + message);
+    }
+
+    // Skip spaces and tabs, and newlines too if `newlines` is set
+    void skipBlank(bool newlines = true) {
+        while (p != end && (*p == ' ' || *p == '\t' || *p == '\r' || (newlines && *p == '\n'))) {
+            if (*p == '\n') ++line;
+            ++p;
+        }
+    }
+
+    void skipLine() {
+        while (p != end && *p != '\n') ++p;
+        if (p != end) {
+            ++p;
+            ++line;
+        }
+    }
+
+    // Header keyword or section name: everything up to whitespace or ':'
+    std::string_view keyword() {
+        skipBlank();
+        const char *start = p;
+        while (p != end && *p != ':' && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') ++p;
+        return {start, static_cast<size_t>(p - start)};
+    }
+
+    // Value of a "KEY : value" header line, trimmed
+    std::string_view headerValue() {
+        skipBlank(false);
+        if (p != end && *p == ':') ++p;
+        skipBlank(false);
+        const char *start = p;
+        while (p != end && *p != '\n') ++p;
+        const char *stop = p;
+        while (stop != start && (stop[-1] == ' ' || stop[-1] == '\t' || stop[-1] == '\r')) --stop;
+        return {start, static_cast<size_t>(stop - start)};
+    }
+
+    bool atNumber() {
+        skipBlank();
+        return p != end && ((*p >= '0' && *p <= '9') || *p == '-' || *p == '+' || *p == '.');
+    }
+
+    template<typename T>
+    T number() {
+        skipBlank();
+        if (p != end && *p == '+') ++p;
+        T value{};
+        auto result = std::from_chars(p, end, value);
+        if (result.ec != std::errc()) {
+            fail("expected a number");
+        }
+        p = result.ptr;
+        return value;
+    }
+
+    // Skip separators (commas, semicolons, spaces) within a CSV line
+    void skipSeparators() {
+        while (p != end && (*p == ',' || *p == ';' || *p == ' ' || *p == '\t' || *p == '\r')) ++p;
+    }
+
+    bool atLineEnd() const { return p == end || *p == '\n'; }
+
+private:
+    std::string path;
+    const char *p;
+    const char *end;
+    size_t line = 1;
+};
+
+bool endsWith(const std::string &s, const std::string &suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+Metric parseMetric(Parser &parser, std::string_view type) {
+    if (type == "EUC_2D") return Metric::Euc2D;
+    if (type == "CEIL_2D") return Metric::Ceil2D;
+    if (type == "ATT") return Metric::Att;
+    if (type == "GEO") return Metric::Geo;
+    if (type == "EXPLICIT") return Metric::Explicit;
+    parser.fail("unsupported EDGE_WEIGHT_TYPE " + std::string(type));
+}
+
+size_t parseDimension(Parser &parser, std::string_view value) {
+    size_t n = 0;
+    auto result = std::from_chars(value.data(), value.data() + value.size(), n);
+    if (result.ec != std::errc() || n == 0) {
+        parser.fail("invalid DIMENSION");
+    }
+    return n;
+}
+
+// "id x y" lines into cities[id - 1]; every id 1..n must appear exactly once
+void parseCoordinates(Parser &parser, size_t n, std::vector<City> &cities) {
+    cities.assign(n, City(0, 0));
+    std::vector<bool> seen(n, false);
+    for (size_t k = 0; k < n; ++k) {
+        if (!parser.atNumber()) {
+            parser.fail("only " + std::to_string(k) + " of DIMENSION " + std::to_string(n) + " nodes listed");
+        }
+        auto id = parser.number<long>();
+        if (id < 1 || static_cast<size_t>(id) > n) {
+            parser.fail("node id " + std::to_string(id) + " out of range");
+        }
+        if (seen[id - 1]) {
+            parser.fail("duplicate node id " + std::to_string(id));
+        }
+        seen[id - 1] = true;
+        double x = parser.number<double>();
+        double y = parser.number<double>();
+        cities[id - 1] = City(x, y);
+    }
+}
+
+// EDGE_WEIGHT_SECTION in the given format into a full row-major matrix. For a symmetric matrix
+// a column-wise upper triangle lists the same numbers as a row-wise lower one and vice versa.
+std::vector<float> parseWeights(Parser &parser, size_t n, std::string_view format) {
+    std::vector<float> matrix(n * n, 0.0f);
+    auto set = [&](size_t i, size_t j) {
+        float w = parser.number<float>();
+        matrix[i * n + j] = w;
+        matrix[j * n + i] = w;
+    };
+    if (format == "FULL_MATRIX") {
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                matrix[i * n + j] = parser.number<float>();
+            }
+        }
+    } else if (format == "UPPER_ROW" || format == "LOWER_COL") {
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = i + 1; j < n; ++j) set(i, j);
+    } else if (format == "LOWER_ROW" || format == "UPPER_COL") {
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < i; ++j) set(i, j);
+    } else if (format == "UPPER_DIAG_ROW" || format == "LOWER_DIAG_COL") {
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = i; j < n; ++j) set(i, j);
+    } else if (format == "LOWER_DIAG_ROW" || format == "UPPER_DIAG_COL") {
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j <= i; ++j) set(i, j);
+    } else {
+        parser.fail("unsupported EDGE_WEIGHT_FORMAT " + std::string(format));
+    }
+    return matrix;
+}
+
+} // namespace
+
+Instance loadInstance(const std::string &path) {
+    if (endsWith(path, ".csv")) {
+        return loadCsv(path);
+    }
+    return loadTsplib(path);
+}
+
+Instance loadTsplib(const std::string &path) {
+    MappedFile file(path);
+    Parser parser(path, file.view());
+    std::map<std::string_view, std::string_view> header;
+    std::vector<City> cities;
+    std::vector<float> matrix;
+    size_t n = 0;
+
+    while (true) {
+        std::string_view key = parser.keyword();
+        if (key.empty() || key == "EOF") {
+            break;
+        }
+        if (key == "NODE_COORD_SECTION" || key == "DISPLAY_DATA_SECTION") {
+            if (n == 0) parser.fail(std::string(key) + " before DIMENSION");
+            std::vector<City> coordinates;
+            parseCoordinates(parser, n, coordinates);
+            // Display coordinates only matter for printing when there are no real ones
+            if (key == "NODE_COORD_SECTION" || cities.empty()) cities = std::move(coordinates);
+        } else if (key == "EDGE_WEIGHT_SECTION") {
+            if (n == 0) parser.fail("EDGE_WEIGHT_SECTION before DIMENSION");
+            matrix = parseWeights(parser, n, header["EDGE_WEIGHT_FORMAT"]);
+        } else if (key.size() > 8 && key.substr(key.size() - 8) == "_SECTION") {
+            parser.fail("unsupported section " + std::string(key));
+        } else {
+            std::string_view value = parser.headerValue();
+            header[key] = value;
+            if (key == "DIMENSION") {
+                n = parseDimension(parser, value);
+            }
+        }
+    }
+
+    std::string_view type = header["TYPE"];
+    if (!type.empty() && type != "TSP") {
+        parser.fail("unsupported TYPE " + std::string(type) + " (only symmetric TSP instances)");
+    }
+    if (n == 0) {
+        parser.fail("missing DIMENSION");
+    }
+    Metric metric = parseMetric(parser, header["EDGE_WEIGHT_TYPE"]);
+    std::string name(header["NAME"]);
+
+    if (metric == Metric::Explicit) {
+        if (matrix.empty()) parser.fail("missing EDGE_WEIGHT_SECTION");
+        Instance instance(name, DistanceTable::explicitMatrix(n, std::move(matrix)));
+        instance.cities = std::move(cities);
+        return instance;
+    }
+    if (cities.empty()) {
+        parser.fail("missing NODE_COORD_SECTION");
+    }
+    return Instance(std::move(cities), name, metric);
+}
+
+Instance loadCsv(const std::string &path) {
+    MappedFile file(path);
+    Parser parser(path, file.view());
+    std::vector<City> cities;
+
+    while (true) {
+        parser.skipBlank();
+        if (parser.atEnd()) {
+            break;
+        }
+        if (!parser.atNumber()) {
+            parser.skipLine();
+            continue;
+        }
+        double values[3];
+        int count = 0;
+        while (!parser.atLineEnd()) {
+            if (count == 3) parser.fail("expected at most three columns");
+            values[count++] = parser.number<double>();
+            parser.skipSeparators();
+        }
+        if (count < 2) parser.fail("expected x and y coordinates");
+        cities.emplace_back(values[count - 2], values[count - 1]);
+    }
+
+    if (cities.empty()) {
+        parser.fail("no cities");
+    }
+    std::string name = path.substr(path.find_last_of('/') + 1);
+    return Instance(std::move(cities), name.substr(0, name.size() - 4));
+}
+
+std::vector<CityId> loadTour(const std::string &path, size_t numCities) {
+    MappedFile file(path);
+    Parser parser(path, file.view());
+    std::vector<CityId> tour;
+    tour.reserve(numCities);
+
+    while (true) {
+        std::string_view key = parser.keyword();
+        if (key.empty() || key == "EOF") {
+            break;
+        }
+        if (key == "TOUR_SECTION") {
+            while (parser.atNumber()) {
+                auto id = parser.number<long>();
+                if (id == -1) break;
+                if (id < 1 || static_cast<size_t>(id) > numCities) {
+                    parser.fail("city " + std::to_string(id) + " out of range");
+                }
+                tour.push_back(static_cast<CityId>(id - 1));
+            }
+        } else {
+            std::string_view value = parser.headerValue();
+            if (key == "DIMENSION" && parseDimension(parser, value) != numCities) {
+                parser.fail("tour is for a different number of cities");
+            }
+        }
+    }
+
+    std::vector<bool> seen(numCities, false);
+    for (CityId city: tour) {
+        if (seen[city]) parser.fail("city " + std::to_string(city + 1) + " visited twice");
+        seen[city] = true;
+    }
+    if (tour.size() != numCities) {
+        parser.fail("tour visits " + std::to_string(tour.size()) + " of " + std::to_string(numCities) + " cities");
+    }
+    return tour;
+}
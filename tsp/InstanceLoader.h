@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "tsp/Instance.h"
+#include "tsp/Route.h"
+
+// Loaders for instance files. Files are memory-mapped and parsed in place with std::from_chars,
+// so even 100k-city instances load without copying the text. All loaders throw
+// std::runtime_error (with the file name and line) on malformed input.
+
+// Load a TSPLIB .tsp file or, for a .csv extension, a coordinate CSV
+Instance loadInstance(const std::string &path);
+
+// TSPLIB .tsp file of TYPE TSP. Supports NODE_COORD_SECTION with EDGE_WEIGHT_TYPE EUC_2D, CEIL_2D,
+// ATT and GEO, and EDGE_WEIGHT_SECTION with EDGE_WEIGHT_TYPE EXPLICIT in the FULL_MATRIX and
+// (UPPER|LOWER)_(DIAG_)(ROW|COL) formats.
+Instance loadTsplib(const std::string &path);
+
+// One city per line as "x,y" or "id,x,y" (commas, semicolons or whitespace as separators);
+// lines that do not start with a number, such as a header, are skipped.
+// Distances are exact Euclidean.
+Instance loadCsv(const std::string &path);
+
+// TSPLIB .tour file (e.g. a known optimum, *.opt.tour); returns the 0-based city order.
+// Throws if the tour is not a permutation of numCities cities.
+std::vector<CityId> loadTour(const std::string &path, size_t numCities);
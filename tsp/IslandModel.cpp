@@ -0,0 +1,148 @@
+#include "tsp/IslandModel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include <omp.h>
+
+#include "common/Profiler.h"
+#include "tsp/MigrationRing.h"
+
+// Send copies of the best routes of an island, best first, until `send` refuses one
+template<typename Send>
+static void emigrate(const Population &population, int migrants, std::vector<size_t> &ranking, Send send) {
+    GA_PROFILE_ZONE(Migration);
+    std::iota(ranking.begin(), ranking.end(), 0);
+    std::partial_sort(ranking.begin(), ranking.begin() + migrants, ranking.end(), [&](size_t a, size_t b) {
+        return population.length(a) < population.length(b);
+    });
+    for (int m = 0; m < migrants; ++m) {
+        if (!send(population.route(ranking[m]))) {
+            break;
+        }
+    }
+}
+
+// Replace the worst routes of an island with whatever migrants `receive` delivers into `arrival`
+template<typename Receive>
+static void immigrate(Population &population, Population &arrival, Receive receive) {
+    GA_PROFILE_ZONE(Migration);
+    while (receive(arrival.route(0))) {
+        size_t worst = 0;
+        for (size_t i = 1; i < population.size(); ++i) {
+            if (population.length(i) > population.length(worst)) {
+                worst = i;
+            }
+        }
+        if (arrival.length(0) < population.length(worst)) {
+            population.route(worst).assign(arrival.route(0));
+        }
+    }
+}
+
+Route runIslandModel(const Instance &instance, const GAParameters &params, const GenerationObserver &observer,
+                     StopCondition *stop, MigrationNode *node) {
+    int islands = params.islands > 0 ? params.islands : omp_get_max_threads();
+    islands = std::max(1, std::min(islands, params.populationSize / 2));
+    int migrants = std::max(0, params.migrants);
+    int interval = std::max(1, params.migrationInterval);
+
+    // rings[i] carries migrants from island i to island i + 1
+    std::vector<std::unique_ptr<MigrationRing>> rings;
+    for (int i = 0; i < islands; ++i) {
+        rings.push_back(std::make_unique<MigrationRing>(std::max(1, 4 * migrants), instance.size()));
+    }
+    // Every node of a distributed run needs islands of its own
+    uint64_t seed = node ? Rng::forStream(params.seed, static_cast<uint64_t>(node->rank()), 2)() : params.seed;
+    // A network error seen by the first island ends all of them
+    std::exception_ptr nodeError;
+    std::atomic<bool> aborted{false};
+    // Filled by every island that actually runs (the team may be smaller than requested)
+    std::vector<Route> bestRoutes(islands);
+    // The candidate lists are built once, in parallel, and shared read-only by the islands
+    std::unique_ptr<LocalSearch> localSearch;
+    if (params.localSearch) {
+        localSearch = std::make_unique<LocalSearch>(instance, params.candidates);
+    }
+
+    #pragma omp parallel num_threads(islands)
+    {
+        int island = omp_get_thread_num();
+        int teamSize = omp_get_num_threads();
+        // Split the population evenly; the first islands take the remainder
+        GAParameters islandParams = params;
+        islandParams.populationSize = params.populationSize / teamSize + (island < params.populationSize % teamSize);
+        islandParams.seed = Rng::forStream(seed, static_cast<uint64_t>(island), 1)();
+        int islandMigrants = std::min(migrants, islandParams.populationSize);
+
+        Population population = initializePopulation(instance, islandParams);
+        if (localSearch) improvePopulation(*localSearch, population, false);
+        Population next(islandParams.populationSize, instance.size());
+        Population arrival(1, instance.size());
+        std::vector<size_t> ranking(islandParams.populationSize);
+        MigrationRing &outgoing = *rings[island];
+        MigrationRing &incoming = *rings[(island + teamSize - 1) % teamSize];
+        MigrationNode *islandNode = island == 0 ? node : nullptr;
+        bool observing = island == 0 && observer;
+        if (observing) observer(0, population);
+        if (stop) stop->addEvaluations(islandParams.populationSize);
+
+        WorstHeap heap;
+        bool steadyState = params.replacement == Replacement::SteadyState;
+        if (steadyState) {
+            heap.build(population.size(), [&](size_t i) { return population.length(i); }, false);
+        }
+
+        bool stopped = stop && stop->update(0, population.length(population.bestIndex()));
+        for (int generation = 1; generation <= params.numGenerations && !stopped && !aborted; ++generation) {
+            nextGeneration(instance, population, next, islandParams, ExecutionPolicy::Serial, generation,
+                           localSearch.get());
+            if (steadyState) {
+                replaceWorst(population, next, heap);
+            } else {
+                population.swap(next);
+            }
+            if ((teamSize > 1 || islandNode) && islandMigrants > 0 && generation % interval == 0) {
+                if (teamSize > 1) {
+                    emigrate(population, islandMigrants, ranking, [&](ConstRouteView route) {
+                        return outgoing.push(route);
+                    });
+                    immigrate(population, arrival, [&](RouteView dst) { return incoming.pop(dst); });
+                }
+                if (islandNode) {
+                    emigrate(population, islandMigrants, ranking, [&](ConstRouteView route) {
+                        islandNode->send(route);
+                        return true;
+                    });
+                    try {
+                        immigrate(population, arrival, [&](RouteView dst) { return islandNode->receive(dst); });
+                    } catch (...) {
+                        nodeError = std::current_exception();
+                        aborted = true;
+                    }
+                }
+                if (steadyState) {
+                    heap.build(population.size(), [&](size_t i) { return population.length(i); }, false);
+                }
+            }
+            if (observing) observer(generation, population);
+            if (stop) {
+                stop->addEvaluations(islandParams.populationSize);
+                stopped = stop->update(generation, population.length(population.bestIndex()));
+            }
+        }
+
+        bestRoutes[island] = Route(population.route(population.bestIndex()));
+    }
+    if (nodeError) {
+        std::rethrow_exception(nodeError);
+    }
+
+    return *std::min_element(bestRoutes.begin(), bestRoutes.end(), [](const Route &a, const Route &b) {
+        return !b.order.empty() && (a.order.empty() || a.length < b.length);
+    });
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "tsp/GeneticAlgorithm.h"
+#include "tsp/MigrationNode.h"
+
+// Island-model GA: every OpenMP thread evolves its own subpopulation with the regular selection,
+// crossover and mutation operators, and every params.migrationInterval generations sends copies
+// of its params.migrants best routes to the next island on a ring, where they replace the worst
+// routes. Migrants travel through lock-free MigrationRings, so islands never wait for each other
+// and there is no per-generation synchronization at all.
+//
+// Each island draws from its own random streams, but since migrants arrive whenever their
+// sender gets to them, runs with more than one island are not bit-reproducible.
+//
+// The observer is called by the first island only, with that island's subpopulation. Every island
+// reports its own best to the shared stop condition, and all of them end at their next generation
+// once it fires.
+//
+// With a MigrationNode the process is one node of a distributed run: its islands are seeded from
+// params.seed and the node's rank (so nodes may share a seed), and at every migration the first
+// island also sends its params.migrants best routes to the node's targets and takes in the
+// migrants that have arrived from other nodes. params.populationSize is then the population of
+// this node. Errors of the node are rethrown once the islands have ended.
+Route runIslandModel(const Instance &instance, const GAParameters &params, const GenerationObserver &observer = {},
+                     StopCondition *stop = nullptr, MigrationNode *node = nullptr);
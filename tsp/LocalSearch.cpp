@@ -0,0 +1,262 @@
+#include "tsp/LocalSearch.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "common/Profiler.h"
+#include "tsp/Moves.h"
+#include "tsp/SpatialGrid.h"
+
+// Moves must gain more than this to be applied, so rounding noise cannot make two moves undo
+// each other forever
+static const double MIN_GAIN = 1e-7;
+
+// Longest segment an Or-opt move relocates
+static const size_t OR_OPT_SEGMENT = 3;
+
+NeighbourLists::NeighbourLists(const Instance &instance, size_t k)
+        : k(std::min(k, instance.size() > 0 ? instance.size() - 1 : 0)), ids(instance.size() * this->k) {
+    const DistanceTable &d = instance.distances;
+    long n = static_cast<long>(instance.size());
+    if (this->k == 0) {
+        return;
+    }
+    if (instance.hasCoordinates() && d.metric() != Metric::Explicit) {
+        SpatialGrid grid(instance.cities);
+        #pragma omp parallel
+        {
+            std::vector<uint32_t> found;
+            #pragma omp for schedule(dynamic, 256)
+            for (long c = 0; c < n; ++c) {
+                grid.nearest(static_cast<size_t>(c), this->k, found);
+                // Rank by the instance's metric, which may round distances differently
+                std::stable_sort(found.begin(), found.end(), [&](uint32_t a, uint32_t b) {
+                    return d(c, a) < d(c, b);
+                });
+                std::copy(found.begin(), found.end(), ids.begin() + c * this->k);
+            }
+        }
+        return;
+    }
+    #pragma omp parallel
+    {
+        std::vector<CityId> row(n);
+        #pragma omp for schedule(dynamic, 64)
+        for (long c = 0; c < n; ++c) {
+            std::iota(row.begin(), row.end(), 0);
+            std::swap(row[c], row.back());
+            std::partial_sort(row.begin(), row.begin() + this->k, row.end() - 1, [&](CityId a, CityId b) {
+                return d(c, a) < d(c, b);
+            });
+            std::copy(row.begin(), row.begin() + this->k, ids.begin() + c * this->k);
+        }
+    }
+}
+
+namespace {
+
+// Navigation and 2-opt moves on a route seen as a cycle, independent of the direction the
+// array happens to run in
+struct Tour {
+    RouteView route;
+    size_t n;
+
+    CityId next(CityId c) const {
+        size_t i = route.positionOf(c);
+        return route.order[i + 1 == n ? 0 : i + 1];
+    }
+
+    CityId prev(CityId c) const {
+        size_t i = route.positionOf(c);
+        return route.order[i == 0 ? n - 1 : i - 1];
+    }
+
+    // Reverse the path that runs forward (in array order) from `from` to `to`. Reversing the rest
+    // of the cycle instead gives the same tour, so the shorter of the two is reversed.
+    void reversePath(CityId from, CityId to) const {
+        size_t i = route.positionOf(from), j = route.positionOf(to);
+        size_t inner = (j + n - i) % n + 1;
+        if (2 * inner > n) {
+            i = j + 1 == n ? 0 : j + 1;
+            j = route.positionOf(from) == 0 ? n - 1 : route.positionOf(from) - 1;
+            inner = n - inner;
+        }
+        for (size_t s = 0; s < inner / 2; ++s) {
+            route.swapPositions(i, j);
+            i = i + 1 == n ? 0 : i + 1;
+            j = j == 0 ? n - 1 : j - 1;
+        }
+    }
+
+    // Replace the tour edges (a, b) and (c, d) by (a, c) and (b, d). Going from a to b, the tour
+    // must reach c before d, in whichever direction the array runs.
+    void twoOpt(CityId a, CityId b, CityId c, CityId /* d */) const {
+        if (next(a) == b) {
+            reversePath(b, c);
+        } else {
+            reversePath(c, b);
+        }
+    }
+};
+
+// Per-thread FIFO of the cities whose don't-look bit is off
+struct ActiveCities {
+    std::vector<CityId> queue;
+    std::vector<uint8_t> active;
+    size_t head = 0, count = 0;
+
+    void reset(size_t n) {
+        queue.resize(n);
+        active.assign(n, 0);
+        head = count = 0;
+    }
+
+    void push(CityId c) {
+        if (active[c]) return;
+        active[c] = 1;
+        queue[(head + count++) % queue.size()] = c;
+    }
+
+    CityId pop() {
+        CityId c = queue[head];
+        head = head + 1 == queue.size() ? 0 : head + 1;
+        --count;
+        active[c] = 0;
+        return c;
+    }
+};
+
+ActiveCities &activeScratch() {
+    static thread_local ActiveCities scratch;
+    return scratch;
+}
+
+// First improving 2-opt move with a tour edge at `a` replaced by an edge to a candidate neighbour
+bool improveTwoOpt(const DistanceTable &d, const NeighbourLists &lists, const Tour &tour, CityId a,
+                   double &delta, ActiveCities &active) {
+    const CityId *candidates = lists.of(a);
+    for (int direction = 0; direction < 2; ++direction) {
+        CityId b = direction == 0 ? tour.next(a) : tour.prev(a);
+        double ab = d(a, b);
+        for (size_t k = 0; k < lists.size(); ++k) {
+            CityId c = candidates[k];
+            double ac = d(a, c);
+            if (ac >= ab) break; // every further candidate is farther still, so nothing can gain
+            CityId e = direction == 0 ? tour.next(c) : tour.prev(c);
+            if (c == b || e == a) continue;
+            double gain = ac + double(d(b, e)) - ab - d(c, e);
+            if (gain < -MIN_GAIN) {
+                tour.twoOpt(a, b, c, e);
+                delta += gain;
+                for (CityId city: {a, b, c, e}) active.push(city);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// First improving Or-opt move of the segment of 1..OR_OPT_SEGMENT cities starting at `s1` (in array
+// order) to between a candidate neighbour of one of its ends and that neighbour's successor or predecessor
+bool improveOrOpt(const DistanceTable &d, const NeighbourLists &lists, const Tour &tour, CityId s1,
+                  double &delta, ActiveCities &active) {
+    size_t n = tour.n;
+    CityId s2 = s1;
+    for (size_t length = 1; length <= OR_OPT_SEGMENT && length + 3 <= n; ++length) {
+        if (length > 1) s2 = tour.next(s2);
+        CityId p = tour.prev(s1), q = tour.next(s2);
+        double removal = double(d(p, s1)) + d(s2, q) - d(p, q);
+        if (removal <= MIN_GAIN) continue;
+        size_t start = tour.route.positionOf(s1);
+        auto inSegment = [&](CityId c) { return (tour.route.positionOf(c) + n - start) % n < length; };
+
+        for (CityId end: {s1, s2}) {
+            if (end == s2 && length == 1) break;
+            CityId other = end == s1 ? s2 : s1;
+            const CityId *candidates = lists.of(end);
+            for (size_t k = 0; k < lists.size(); ++k) {
+                CityId c = candidates[k];
+                double ce = d(c, end);
+                if (ce >= removal) break;
+                if (inSegment(c)) continue;
+                for (CityId e: {tour.next(c), tour.prev(c)}) {
+                    if (inSegment(e)) continue;
+                    double gain = ce + double(d(other, e)) - d(c, e) - removal;
+                    if (gain >= -MIN_GAIN) continue;
+                    // Three 2-opt moves: cut the segment out and close the gap p-q, then turn the
+                    // segment so that `end` faces c. e1 is whichever of c and e comes first after q
+                    // when walking from p into the segment.
+                    bool forward = tour.next(p) == s1;
+                    CityId e1 = (tour.next(c) == e) == forward ? c : e;
+                    CityId e2 = e1 == c ? e : c;
+                    tour.twoOpt(p, s1, e1, e2);
+                    tour.twoOpt(p, e1, q, s2);
+                    // Now e1-s2 and s1-e2 are tour edges
+                    if ((e1 == c) != (end == s2)) {
+                        tour.twoOpt(e1, s2, s1, e2);
+                    }
+                    delta += gain;
+                    for (CityId city: {p, q, c, e, s1, s2}) active.push(city);
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+LocalSearch::LocalSearch(const Instance &instance, size_t candidates)
+        : instance(instance), lists(instance, candidates) {}
+
+void LocalSearch::improve(RouteView route) const {
+    run(route, nullptr);
+}
+
+void LocalSearch::improve(RouteView route, ConstRouteView reference) const {
+    run(route, &reference);
+}
+
+void LocalSearch::run(RouteView route, const ConstRouteView *reference) const {
+    GA_PROFILE_ZONE(LocalSearch);
+    size_t n = route.size();
+    if (n < 5 || lists.size() == 0) {
+        return;
+    }
+    const DistanceTable &d = instance.distances;
+    Tour tour{route, n};
+    ActiveCities &active = activeScratch();
+    active.reset(n);
+    for (size_t i = 0; i < n; ++i) {
+        CityId c = route.order[i];
+        if (reference) {
+            // Unchanged if both tour neighbours are the reference's neighbours, in either direction
+            size_t r = reference->positionOf(c);
+            CityId rn = (*reference)[r + 1 == n ? 0 : r + 1], rp = (*reference)[r == 0 ? n - 1 : r - 1];
+            CityId cn = tour.next(c), cp = tour.prev(c);
+            if ((cn == rn && cp == rp) || (cn == rp && cp == rn)) continue;
+        }
+        active.push(c);
+    }
+
+    double delta = 0.0;
+    while (active.count > 0) {
+        CityId a = active.pop();
+        if (improveTwoOpt(d, lists, tour, a, delta, active) || improveOrOpt(d, lists, tour, a, delta, active)) {
+            active.push(a);
+        }
+    }
+    *route.length += delta;
+#ifdef TSP_CHECK_DELTAS
+    checkRouteLength(instance, route, "local search");
+#endif
+}
+
+void improvePopulation(const LocalSearch &localSearch, Population &population, bool parallel) {
+    long size = static_cast<long>(population.size());
+    #pragma omp parallel for schedule(dynamic) if(parallel)
+    for (long i = 0; i < size; ++i) {
+        localSearch.improve(population.route(i));
+    }
+}
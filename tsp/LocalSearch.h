@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "tsp/Instance.h"
+#include "tsp/Population.h"
+#include "tsp/Route.h"
+
+// The k nearest cities of every city, nearest first: the candidate set of the local search.
+// Instances with coordinates are indexed with a SpatialGrid; explicit matrices are scanned row by
+// row. Built in parallel.
+class NeighbourLists {
+public:
+    NeighbourLists() = default;
+    NeighbourLists(const Instance &instance, size_t k);
+
+    // Number of candidates per city (min(k, n - 1))
+    size_t size() const { return k; }
+    const CityId *of(size_t city) const { return &ids[city * k]; }
+
+private:
+    size_t k = 0;
+    std::vector<CityId> ids;
+};
+
+// Memetic improvement of routes: 2-opt and Or-opt (moving a segment of one to three cities,
+// possibly reversed) restricted to candidate neighbours, with don't-look bits. A city is only
+// re-examined after one of its tour edges changed, so a route that differs from a local optimum
+// in a few places is repaired in time proportional to the changes rather than to n. Moves are
+// performed as segment reversals of the shorter side and keep the route length up to date from
+// their deltas, like the operators in tsp/Moves.h.
+//
+// The search is deterministic and reads only shared, immutable data, so one LocalSearch can be
+// used by all threads at once.
+class LocalSearch {
+public:
+    LocalSearch(const Instance &instance, size_t candidates);
+
+    // Improve the route until no candidate move shortens it, examining every city
+    void improve(RouteView route) const;
+
+    // Same, but start only from the cities whose tour neighbours differ from those in `reference`
+    // (e.g. a locally optimal parent the route was derived from)
+    void improve(RouteView route, ConstRouteView reference) const;
+
+    const NeighbourLists &neighbours() const { return lists; }
+
+private:
+    const Instance &instance;
+    NeighbourLists lists;
+
+    void run(RouteView route, const ConstRouteView *reference) const;
+};
+
+// Improve every route of a population, with an OpenMP parallel loop if `parallel` is set
+void improvePopulation(const LocalSearch &localSearch, Population &population, bool parallel);
@@ -0,0 +1,623 @@
+#include "tsp/MigrationNode.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "tsp/Codec.h"
+
+namespace {
+
+enum FrameType : uint32_t { HELLO = 1, MIGRANT = 2, BEST = 3 };
+
+const std::string UNIX_PREFIX = "unix:";
+
+// Further migrants are only encoded for a connection once this much of its output has been sent,
+// so a slow peer backs up into its (bounded) queue instead of into memory
+const size_t OUTPUT_BATCH = size_t(1) << 20;
+
+// A socket address from HOST:PORT or unix:PATH
+struct Endpoint {
+    sockaddr_storage storage{};
+    socklen_t size = 0;
+    std::string path; // Unix domain sockets only
+};
+
+Endpoint resolve(const std::string &address) {
+    Endpoint endpoint;
+    if (address.compare(0, UNIX_PREFIX.size(), UNIX_PREFIX) == 0) {
+        endpoint.path = address.substr(UNIX_PREFIX.size());
+        sockaddr_un local{};
+        if (endpoint.path.empty() || endpoint.path.size() >= sizeof(local.sun_path)) {
+            throw std::invalid_argument("bad Unix socket path in '" + address + "'");
+        }
+        local.sun_family = AF_UNIX;
+        std::memcpy(local.sun_path, endpoint.path.c_str(), endpoint.path.size() + 1);
+        std::memcpy(&endpoint.storage, &local, sizeof(local));
+        endpoint.size = sizeof(local);
+        return endpoint;
+    }
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos || colon == 0 || colon + 1 == address.size()) {
+        throw std::invalid_argument("bad peer address '" + address + "' (expected HOST:PORT or unix:PATH)");
+    }
+    std::string host = address.substr(0, colon);
+    std::string port = address.substr(colon + 1);
+    if (host.size() > 2 && host.front() == '[' && host.back() == ']') {
+        host = host.substr(1, host.size() - 2);
+    }
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *result = nullptr;
+    int status = ::getaddrinfo(host.c_str(), port.c_str(), &hints, &result);
+    if (status != 0) {
+        throw std::runtime_error("cannot resolve " + address + ": " + ::gai_strerror(status));
+    }
+    std::memcpy(&endpoint.storage, result->ai_addr, result->ai_addrlen);
+    endpoint.size = result->ai_addrlen;
+    ::freeaddrinfo(result);
+    return endpoint;
+}
+
+void setNonBlocking(int fd) {
+    int flags = ::fcntl(fd, F_GETFL);
+    if (flags < 0 || ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0) {
+        throw std::system_error(errno, std::generic_category(), "cannot configure a socket");
+    }
+}
+
+int listenOn(const std::string &address) {
+    Endpoint endpoint = resolve(address);
+    int fd = ::socket(endpoint.storage.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "cannot create a socket for " + address);
+    }
+    if (!endpoint.path.empty()) {
+        ::unlink(endpoint.path.c_str()); // left behind by an earlier run
+    } else {
+        int on = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    }
+    if (::bind(fd, reinterpret_cast<const sockaddr *>(&endpoint.storage), endpoint.size) != 0 ||
+        ::listen(fd, SOMAXCONN) != 0) {
+        int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "cannot listen on " + address);
+    }
+    setNonBlocking(fd);
+    return fd;
+}
+
+// Waits for a non-blocking connect until `deadline`; returns its errno value, 0 once connected
+int awaitConnect(int fd, std::chrono::steady_clock::time_point deadline) {
+    while (true) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        pollfd connecting{fd, POLLOUT, 0};
+        int ready = ::poll(&connecting, 1, static_cast<int>(std::max<long long>(0, left.count())));
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready < 0) return errno;
+        if (ready == 0) return ETIMEDOUT;
+        int error = 0;
+        socklen_t size = sizeof(error);
+        if (::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &size) != 0) return errno;
+        return error;
+    }
+}
+
+// Size of a migrant or best frame after its size field
+size_t routeFrameSize(size_t cities) {
+    return 4 + 8 + (cities * static_cast<size_t>(cityIdWidth(cities)) + 7) / 8;
+}
+
+// Appends a migrant or best frame
+void encodeRoute(std::vector<unsigned char> &out, FrameType type, const CityId *order, size_t n, double length) {
+    size_t start = out.size();
+    ByteEncoder encoder(out);
+    encoder.u32(0); // size, patched below
+    encoder.u32(type);
+    encoder.f64(length);
+    encoder.ids(order, n, cityIdWidth(n));
+    encoder.flushIds();
+    auto size = static_cast<uint32_t>(out.size() - start - 4);
+    for (int b = 0; b < 4; ++b) out[start + b] = static_cast<unsigned char>(size >> (8 * b));
+}
+
+} // namespace
+
+struct MigrationNode::Connection {
+    int fd = -1;
+    std::string source; // the peer in error messages
+    int peer = -1;      // rank; -1 for an incoming connection until its hello arrives
+    bool outgoing = false;
+    MigrationRing *queue = nullptr; // outgoing: migrants waiting to be encoded
+    std::vector<unsigned char> input;
+    std::vector<unsigned char> output;
+    size_t written = 0; // bytes of output already sent
+
+    ~Connection() {
+        if (fd >= 0) ::close(fd);
+    }
+};
+
+MigrationTopology parseMigrationTopology(const std::string &name) {
+    if (name == "ring") return MigrationTopology::Ring;
+    if (name == "star") return MigrationTopology::Star;
+    if (name == "random") return MigrationTopology::Random;
+    throw std::invalid_argument("unknown topology '" + name + "' (expected ring, star or random)");
+}
+
+const char *migrationTopologyName(MigrationTopology topology) {
+    switch (topology) {
+        case MigrationTopology::Ring:
+            return "ring";
+        case MigrationTopology::Star:
+            return "star";
+        case MigrationTopology::Random:
+            return "random";
+    }
+    return "unknown";
+}
+
+std::vector<int> migrationTargets(MigrationTopology topology, int rank, int nodes) {
+    std::vector<int> targets;
+    if (nodes < 2) {
+        return targets;
+    }
+    switch (topology) {
+        case MigrationTopology::Ring:
+            targets.push_back((rank + 1) % nodes);
+            break;
+        case MigrationTopology::Star:
+            if (rank != 0) {
+                targets.push_back(0);
+                break;
+            }
+            for (int peer = 1; peer < nodes; ++peer) targets.push_back(peer);
+            break;
+        case MigrationTopology::Random:
+            for (int peer = 0; peer < nodes; ++peer) {
+                if (peer != rank) targets.push_back(peer);
+            }
+            break;
+    }
+    return targets;
+}
+
+MigrationNode::MigrationNode(const NodeOptions &options, const Instance &instance, size_t capacity)
+        : options(options), instance(instance), cities(instance.size()),
+          fingerprint(instanceFingerprint(instance)),
+          rng(Rng::forStream(options.seed, static_cast<uint64_t>(options.rank), 3)),
+          incoming(std::max<size_t>(1, capacity), instance.size()), scratch(1, instance.size()),
+          seen(instance.size()) {
+    if (options.peers.empty() || options.rank < 0 || options.rank >= nodes()) {
+        throw std::invalid_argument("the rank of a node must index its list of peers");
+    }
+    if (options.connectTimeout < 0) {
+        throw std::invalid_argument("the connect timeout must not be negative");
+    }
+    targets = migrationTargets(options.topology, options.rank, nodes());
+    for (int peer = 0; peer < nodes(); ++peer) {
+        std::vector<int> theirs = migrationTargets(options.topology, peer, nodes());
+        bool sends = std::find(theirs.begin(), theirs.end(), options.rank) != theirs.end();
+        if (peer != options.rank && (sends || options.rank == 0)) sources.push_back(peer);
+    }
+    peerStates.assign(nodes(), PeerState::Unknown);
+    for (size_t k = 0; k < targets.size(); ++k) {
+        outgoing.push_back(std::make_unique<MigrationRing>(std::max<size_t>(1, capacity), cities));
+    }
+
+    int pipeFds[2];
+    if (::pipe2(pipeFds, O_NONBLOCK | O_CLOEXEC) != 0) {
+        throw std::system_error(errno, std::generic_category(), "cannot create a pipe");
+    }
+    wakeRead = pipeFds[0];
+    wakeWrite = pipeFds[1];
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::duration<double>(options.connectTimeout));
+    try {
+        // Every node listens before it connects, so nodes may start in any order
+        listener = listenOn(options.peers[options.rank]);
+        for (int peer: targets) {
+            connectTo(peer, deadline);
+        }
+        if (options.rank != 0 && std::find(targets.begin(), targets.end(), 0) == targets.end()) {
+            connectTo(0, deadline);
+        }
+    } catch (...) {
+        closeSockets();
+        throw;
+    }
+    network = std::thread(&MigrationNode::run, this);
+
+    // Startup barrier: wait for every node that connects to this one, so that none of them can
+    // finish and go away before all the others have reached it
+    std::unique_lock<std::mutex> lock(mutex);
+    auto connected = [&] {
+        return std::all_of(sources.begin(), sources.end(), [&](int peer) {
+            return peerStates[peer] != PeerState::Unknown;
+        });
+    };
+    changed.wait_until(lock, deadline, [&] { return error || connected(); });
+    std::exception_ptr failure = error;
+    if (!failure && !connected()) {
+        std::string missing;
+        for (int peer: sources) {
+            if (peerStates[peer] == PeerState::Unknown) missing += " " + std::to_string(peer);
+        }
+        failure = std::make_exception_ptr(std::runtime_error(
+                "node " + std::to_string(options.rank) + " was not reached by node(s)" + missing +
+                " within the connect timeout"));
+    }
+    lock.unlock();
+    if (failure) {
+        stopNetwork(true);
+        std::rethrow_exception(failure);
+    }
+}
+
+MigrationNode::~MigrationNode() {
+    stopNetwork(false);
+}
+
+void MigrationNode::stopNetwork(bool abandon) {
+    abandoned.store(abandon);
+    stopping.store(true);
+    wake();
+    if (network.joinable()) {
+        network.join();
+    }
+    closeSockets();
+}
+
+bool MigrationNode::sourcesSettled() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::all_of(sources.begin(), sources.end(), [&](int peer) {
+        return peerStates[peer] == PeerState::Finished || peerStates[peer] == PeerState::Gone;
+    });
+}
+
+void MigrationNode::closeSockets() {
+    connections.clear();
+    for (int *fd: {&listener, &wakeRead, &wakeWrite}) {
+        if (*fd >= 0) ::close(*fd);
+        *fd = -1;
+    }
+    const std::string &address = options.peers[options.rank];
+    if (address.compare(0, UNIX_PREFIX.size(), UNIX_PREFIX) == 0) {
+        ::unlink(address.c_str() + UNIX_PREFIX.size());
+    }
+}
+
+void MigrationNode::connectTo(int peer, std::chrono::steady_clock::time_point deadline) {
+    const std::string &address = options.peers[peer];
+    Endpoint endpoint = resolve(address);
+    auto connection = std::make_unique<Connection>();
+    connection->source = "node " + std::to_string(peer) + " (" + address + ")";
+    connection->peer = peer;
+    connection->outgoing = true;
+    while (true) {
+        // Non-blocking, so that an unreachable host cannot hold the node past the deadline
+        connection->fd = ::socket(endpoint.storage.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (connection->fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "cannot create a socket for " + address);
+        }
+        int error = 0;
+        if (::connect(connection->fd, reinterpret_cast<const sockaddr *>(&endpoint.storage), endpoint.size) != 0) {
+            error = errno == EINPROGRESS ? awaitConnect(connection->fd, deadline) : errno;
+        }
+        if (error == 0) {
+            break;
+        }
+        ::close(connection->fd);
+        connection->fd = -1;
+        // Refused (or no socket file yet) while the peer is still starting up
+        bool starting = error == ECONNREFUSED || error == ENOENT || error == EAGAIN || error == EINTR ||
+                        error == ETIMEDOUT;
+        if (!starting || std::chrono::steady_clock::now() >= deadline) {
+            throw std::system_error(error, std::generic_category(), "cannot connect to " + connection->source);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    if (endpoint.path.empty()) {
+        int on = 1;
+        ::setsockopt(connection->fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+
+    ByteEncoder encoder(connection->output);
+    encoder.u32(20);
+    encoder.u32(HELLO);
+    encoder.u32(static_cast<uint32_t>(options.rank));
+    encoder.u64(fingerprint);
+    encoder.u32(static_cast<uint32_t>(cities));
+    auto target = std::find(targets.begin(), targets.end(), peer);
+    if (target != targets.end()) {
+        connection->queue = outgoing[target - targets.begin()].get();
+    }
+    connections.push_back(std::move(connection));
+}
+
+void MigrationNode::wake() {
+    char byte = 1;
+    // A full pipe wakes the network thread just as well
+    if (wakeWrite >= 0 && ::write(wakeWrite, &byte, 1) < 0) {
+        return;
+    }
+}
+
+void MigrationNode::send(ConstRouteView route) {
+    if (targets.empty()) {
+        return;
+    }
+    if (options.topology == MigrationTopology::Random) {
+        if (!outgoing[rng.below(static_cast<uint32_t>(targets.size()))]->push(route)) ++droppedCount;
+    } else {
+        for (const auto &queue: outgoing) {
+            if (!queue->push(route)) ++droppedCount;
+        }
+    }
+    wake();
+}
+
+bool MigrationNode::receive(RouteView dst) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (error) std::rethrow_exception(error);
+    }
+    return incoming.pop(dst);
+}
+
+Route MigrationNode::gatherBest(const Route &best) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (options.rank != 0) {
+        encodeRoute(bestFrame, BEST, best.order.data(), best.order.size(), best.length);
+        lock.unlock();
+        wake();
+        return best;
+    }
+
+    // Nodes that never said hello are given up on after the connect timeout
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::duration<double>(options.connectTimeout));
+    auto settled = [&] {
+        bool late = std::chrono::steady_clock::now() >= deadline;
+        for (int peer = 1; peer < nodes(); ++peer) {
+            PeerState state = peerStates[peer];
+            if (state == PeerState::Connected || (state == PeerState::Unknown && !late)) return false;
+        }
+        return true;
+    };
+    while (!error && !settled()) {
+        changed.wait_for(lock, std::chrono::milliseconds(100));
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    Route result = best;
+    for (const Route &route: bests) {
+        if (route.length < result.length) result = route;
+    }
+    return result;
+}
+
+void MigrationNode::setPeerState(int peer, PeerState state) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (peerStates[peer] != PeerState::Finished) {
+        peerStates[peer] = state;
+    }
+    changed.notify_all();
+}
+
+void MigrationNode::recordError(std::exception_ptr failure) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!error) error = std::move(failure);
+    changed.notify_all();
+}
+
+void MigrationNode::run() {
+    std::vector<pollfd> fds;
+    bool lingering = false;
+    std::chrono::steady_clock::time_point lingerUntil;
+    while (true) {
+        // Once the node is stopping, pending frames (above all a best route) still get flushed; then
+        // it hangs up on its targets, but keeps listening until the nodes that send to it have gone
+        if (!lingering && stopping.load()) {
+            lingering = true;
+            lingerUntil = std::chrono::steady_clock::now();
+            if (!abandoned.load()) {
+                lingerUntil += std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::duration<double>(options.connectTimeout));
+            }
+        }
+        bool sending = false;
+        for (const auto &connection: connections) {
+            if (!connection->outgoing) continue;
+            fillOutput(*connection);
+            bool flushed = connection->written == connection->output.size();
+            if (lingering && (flushed || std::chrono::steady_clock::now() >= lingerUntil)) {
+                ::close(connection->fd);
+                connection->fd = -1;
+            } else {
+                sending = true;
+            }
+        }
+        connections.erase(std::remove_if(connections.begin(), connections.end(),
+                                         [](const std::unique_ptr<Connection> &c) { return c->fd < 0; }),
+                          connections.end());
+        if (lingering && !sending && (abandoned.load() || sourcesSettled())) {
+            return;
+        }
+
+        fds.clear();
+        fds.push_back({wakeRead, POLLIN, 0});
+        fds.push_back({listener, POLLIN, 0});
+        for (const auto &connection: connections) {
+            bool writing = connection->written < connection->output.size();
+            fds.push_back({connection->fd, static_cast<short>(writing ? POLLIN | POLLOUT : POLLIN), 0});
+        }
+        if (::poll(fds.data(), fds.size(), lingering ? 50 : -1) < 0) {
+            if (errno == EINTR) continue;
+            recordError(std::make_exception_ptr(std::system_error(errno, std::generic_category(), "poll")));
+            return;
+        }
+
+        if (fds[0].revents) {
+            char buffer[256];
+            while (::read(wakeRead, buffer, sizeof(buffer)) > 0) {}
+        }
+        size_t polled = connections.size();
+        if (fds[1].revents & POLLIN) {
+            int fd;
+            while ((fd = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+                auto connection = std::make_unique<Connection>();
+                connection->fd = fd;
+                connection->source = "a connection to node " + std::to_string(options.rank);
+                connections.push_back(std::move(connection));
+            }
+        }
+        for (size_t i = 0; i < polled; ++i) {
+            Connection &connection = *connections[i];
+            short events = fds[i + 2].revents;
+            bool open = true;
+            if (events & (POLLIN | POLLHUP | POLLERR)) open = readFrom(connection);
+            if (open && (events & POLLOUT)) open = writeTo(connection);
+            if (!open) {
+                // Whether a node is still running is told by its connection to this one only
+                if (!connection.outgoing && connection.peer >= 0) setPeerState(connection.peer, PeerState::Gone);
+                ::close(connection.fd);
+                connection.fd = -1;
+            }
+        }
+        connections.erase(std::remove_if(connections.begin(), connections.end(),
+                                         [](const std::unique_ptr<Connection> &c) { return c->fd < 0; }),
+                          connections.end());
+    }
+}
+
+void MigrationNode::fillOutput(Connection &connection) {
+    if (connection.written == connection.output.size()) {
+        connection.output.clear();
+        connection.written = 0;
+    }
+    if (connection.peer == 0) {
+        std::lock_guard<std::mutex> lock(mutex);
+        connection.output.insert(connection.output.end(), bestFrame.begin(), bestFrame.end());
+        bestFrame.clear();
+    }
+    if (!connection.queue || stopping.load() || connection.output.size() - connection.written >= OUTPUT_BATCH) {
+        return;
+    }
+    RouteView route = scratch.route(0);
+    while (connection.output.size() - connection.written < OUTPUT_BATCH && connection.queue->pop(route)) {
+        encodeRoute(connection.output, MIGRANT, route.order, cities, *route.length);
+        ++sentCount;
+    }
+}
+
+bool MigrationNode::writeTo(Connection &connection) {
+    while (connection.written < connection.output.size()) {
+        ssize_t count = ::send(connection.fd, connection.output.data() + connection.written,
+                               connection.output.size() - connection.written, MSG_NOSIGNAL);
+        if (count > 0) {
+            connection.written += static_cast<size_t>(count);
+        } else if (count < 0 && errno == EINTR) {
+            continue;
+        } else {
+            // A peer that has finished its run is not an error
+            return count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        }
+    }
+    return true;
+}
+
+bool MigrationNode::readFrom(Connection &connection) {
+    bool open = true;
+    unsigned char buffer[65536];
+    while (true) {
+        ssize_t count = ::recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (count > 0) {
+            connection.input.insert(connection.input.end(), buffer, buffer + count);
+        } else if (count < 0 && errno == EINTR) {
+            continue;
+        } else {
+            open = count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+            break;
+        }
+    }
+
+    // Handle the complete frames, also those that arrived just before the peer closed
+    size_t offset = 0;
+    try {
+        while (connection.input.size() - offset >= 4) {
+            ByteDecoder header(connection.source, &connection.input[offset], &connection.input[offset] + 4);
+            uint32_t size = header.u32();
+            if (size < 4 || size > routeFrameSize(cities)) header.fail("bad frame size " + std::to_string(size));
+            if (connection.input.size() - offset - 4 < size) break;
+            handleFrame(connection, &connection.input[offset + 4], size);
+            offset += 4 + size;
+        }
+    } catch (...) {
+        recordError(std::current_exception());
+        return false;
+    }
+    connection.input.erase(connection.input.begin(), connection.input.begin() + static_cast<ptrdiff_t>(offset));
+    return open;
+}
+
+void MigrationNode::handleFrame(Connection &connection, const unsigned char *frame, size_t size) {
+    ByteDecoder decoder(connection.source, frame, frame + size);
+    uint32_t type = decoder.u32();
+    if ((type == HELLO && size != 20) || ((type == MIGRANT || type == BEST) && size != routeFrameSize(cities))) {
+        decoder.fail("frame of type " + std::to_string(type) + " has the wrong size " + std::to_string(size));
+    }
+    if (type == HELLO) {
+        uint32_t peer = decoder.u32();
+        uint64_t peerFingerprint = decoder.u64();
+        uint32_t n = decoder.u32();
+        if (connection.peer >= 0 || peer >= static_cast<uint32_t>(nodes()) || static_cast<int>(peer) == rank()) {
+            decoder.fail("unexpected hello from node " + std::to_string(peer));
+        }
+        if (n != cities || peerFingerprint != fingerprint) {
+            decoder.fail("node " + std::to_string(peer) + " solves a different instance");
+        }
+        connection.peer = static_cast<int>(peer);
+        setPeerState(connection.peer, PeerState::Connected);
+        return;
+    }
+    if (connection.peer < 0 || (type != MIGRANT && type != BEST)) {
+        decoder.fail("unexpected frame of type " + std::to_string(type));
+    }
+
+    RouteView route = scratch.route(0);
+    decoder.f64(); // the sender's length; a faulty peer could claim any, so it is recomputed
+    decoder.ids(route.order, cities, cityIdWidth(cities));
+    std::fill(seen.begin(), seen.end(), 0);
+    for (size_t k = 0; k < cities; ++k) {
+        if (seen[route.order[k]]) decoder.fail("received a route that is not a permutation");
+        seen[route.order[k]] = 1;
+    }
+    *route.length = instance.distances.tourLength(route.order, cities);
+    if (type == BEST) {
+        route.rebuildPositions();
+        std::lock_guard<std::mutex> lock(mutex);
+        bests.emplace_back(ConstRouteView(route));
+        peerStates[connection.peer] = PeerState::Finished;
+        changed.notify_all();
+    } else if (incoming.push(route)) {
+        ++receivedCount;
+    } else {
+        ++droppedCount;
+    }
+}
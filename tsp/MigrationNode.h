@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/Random.h"
+#include "tsp/Instance.h"
+#include "tsp/MigrationRing.h"
+#include "tsp/Population.h"
+#include "tsp/Route.h"
+
+// Migration between the processes of a distributed island run. Every process (a node) runs the
+// island model on its own population (see runIslandModel in tsp/IslandModel.h), and its first
+// island also exchanges migrants with the other nodes over TCP or Unix domain sockets. A node is
+// addressed by its rank, the index of its address in the list of peers shared by all nodes.
+//
+// The GA thread only copies routes into and out of MigrationRings; a background thread encodes
+// them as frames of packed city ids (see tsp/Codec.h) and does all socket I/O, so a slow or
+// finished peer never stalls the GA. Migrants that find a full queue are dropped.
+//
+// Frames (integers little-endian): u32 size of the rest, u32 type, then
+//   hello:   u32 rank, u64 instance fingerprint, u32 cities (first frame of every connection)
+//   migrant: f64 tour length, city order as ids of cityIdWidth(cities) bits (the receiver
+//            recomputes the length rather than trusting it)
+//   best:    like migrant; the final best route of a node, sent to node 0
+
+enum class MigrationTopology {
+    Ring,  // node r sends to node r + 1
+    Star,  // node 0 sends to every other node, which send to node 0
+    Random // every migrant goes to another node drawn at random
+};
+
+// Parse "ring", "star" or "random"; throws on anything else
+MigrationTopology parseMigrationTopology(const std::string &name);
+const char *migrationTopologyName(MigrationTopology topology);
+
+// Ranks that node `rank` of `nodes` sends its migrants to
+std::vector<int> migrationTargets(MigrationTopology topology, int rank, int nodes);
+
+struct NodeOptions {
+    // Listening address of every node, indexed by rank: HOST:PORT or unix:PATH
+    std::vector<std::string> peers;
+    int rank = 0;
+    MigrationTopology topology = MigrationTopology::Ring;
+    // Seconds to wait for the other nodes to start listening, and at the end for their results
+    double connectTimeout = 30.0;
+    // Of the random topology's target draws
+    uint64_t seed = 0;
+};
+
+class MigrationNode {
+public:
+    // Listens on the node's own address, connects to its targets and to node 0, retrying until they
+    // listen, and waits until every node that sends to this one (every node, for node 0) has
+    // connected. Throws std::invalid_argument on bad options and std::runtime_error if an address
+    // cannot be used or a node does not connect within the connect timeout. `capacity` is the
+    // number of migrants each queue holds; `instance` must outlive the node.
+    MigrationNode(const NodeOptions &options, const Instance &instance, size_t capacity);
+    // Flushes what is still queued for the targets and hangs up on them, then keeps listening until
+    // every node connected to this one has finished or gone away
+    ~MigrationNode();
+
+    MigrationNode(const MigrationNode &) = delete;
+    MigrationNode &operator=(const MigrationNode &) = delete;
+
+    int rank() const { return options.rank; }
+    int nodes() const { return static_cast<int>(options.peers.size()); }
+    MigrationTopology topology() const { return options.topology; }
+
+    // GA thread: queue a copy of `route` for the targets of the topology
+    void send(ConstRouteView route);
+
+    // GA thread: copy the oldest migrant that has arrived into `dst`; returns false if there is none.
+    // Rethrows the error of the network thread (e.g. a peer solving another instance).
+    bool receive(RouteView dst);
+
+    // End of the run. Node 0 waits until every other node has sent its best route or gone away and
+    // returns the shortest of all; the other nodes send `best` to node 0 and return it.
+    Route gatherBest(const Route &best);
+
+    size_t sent() const { return sentCount; }
+    size_t received() const { return receivedCount; }
+    size_t dropped() const { return droppedCount; }
+
+private:
+    struct Connection;
+    enum class PeerState { Unknown, Connected, Finished, Gone };
+
+    NodeOptions options;
+    const Instance &instance;
+    size_t cities;
+    uint64_t fingerprint;
+    std::vector<int> targets;
+    std::vector<int> sources; // nodes that connect to this one: those sending to it, and all for node 0
+    Rng rng; // GA thread, random topology only
+
+    // Network thread state
+    int listener = -1;
+    int wakeRead = -1;
+    int wakeWrite = -1;
+    std::vector<std::unique_ptr<Connection>> connections;
+    std::vector<std::unique_ptr<MigrationRing>> outgoing; // by target, see `targets`
+    MigrationRing incoming;
+    Population scratch; // a route between a ring and a frame
+    std::vector<char> seen;
+    std::thread network;
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> abandoned{false}; // stop without flushing or waiting for the sources
+
+    std::atomic<size_t> sentCount{0};
+    std::atomic<size_t> receivedCount{0};
+    std::atomic<size_t> droppedCount{0};
+
+    // Shared by both threads
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<PeerState> peerStates;
+    std::vector<Route> bests; // node 0: best routes of the other nodes
+    std::vector<unsigned char> bestFrame; // other nodes: waiting to be sent to node 0
+    std::exception_ptr error;
+
+    void wake();
+    void connectTo(int peer, std::chrono::steady_clock::time_point deadline);
+    void stopNetwork(bool abandon);
+    void closeSockets();
+    bool sourcesSettled();
+    void run();
+    void fillOutput(Connection &connection);
+    // Return false once the connection is closed
+    bool readFrom(Connection &connection);
+    bool writeTo(Connection &connection);
+    void handleFrame(Connection &connection, const unsigned char *frame, size_t size);
+    void setPeerState(int peer, PeerState state);
+    void recordError(std::exception_ptr failure);
+};
@@ -0,0 +1,32 @@
+#include "tsp/MigrationRing.h"
+
+#include <algorithm>
+
+MigrationRing::MigrationRing(size_t capacity, size_t numCities)
+        : capacity(capacity), cities(numCities), orders(capacity * numCities), lengths(capacity) {}
+
+bool MigrationRing::push(ConstRouteView route) {
+    size_t t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) == capacity) {
+        return false;
+    }
+    size_t slot = t % capacity;
+    std::copy(route.order, route.order + cities, &orders[slot * cities]);
+    lengths[slot] = route.length;
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+}
+
+bool MigrationRing::pop(RouteView dst) {
+    size_t h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire)) {
+        return false;
+    }
+    size_t slot = h % capacity;
+    const CityId *order = &orders[slot * cities];
+    std::copy(order, order + cities, dst.order);
+    dst.rebuildPositions();
+    *dst.length = lengths[slot];
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "tsp/Route.h"
+
+// Bounded single-producer/single-consumer queue of migrant routes between two islands.
+// Slots are preallocated, so pushing and popping only copy city ids; the producer and consumer
+// synchronize through the head/tail counters alone, without locks or barriers.
+class MigrationRing {
+public:
+    MigrationRing(size_t capacity, size_t numCities);
+
+    // Producer side: copy a route into the ring; returns false (dropping the migrant) if it is full
+    bool push(ConstRouteView route);
+
+    // Consumer side: copy the oldest migrant into `dst`; returns false if the ring is empty
+    bool pop(RouteView dst);
+
+private:
+    size_t capacity;
+    size_t cities;
+    std::vector<CityId> orders;
+    std::vector<double> lengths;
+    // Counters only ever grow; slot = counter % capacity
+    alignas(64) std::atomic<size_t> head{0}; // next migrant to read
+    alignas(64) std::atomic<size_t> tail{0}; // next free slot to write
+};
@@ -0,0 +1,15 @@
+#include "tsp/Moves.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+void checkRouteLength(const Instance &instance, ConstRouteView route, const char *move) {
+    double expected = instance.distances.tourLength(route.order, route.size());
+    if (std::abs(expected - route.length) > 1e-6 * std::max(1.0, expected)) {
+        std::cerr << "Error: incremental " << move << " left route length " << route.length
+                  << " but a full recompute gives " << expected << std::endl;
+        std::abort();
+    }
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#include "tsp/Instance.h"
+#include "tsp/Route.h"
+
+// Move operators on a route. Each one has a *Delta function that computes the change in
+// tour length from the (at most six) edges it touches in O(1) using the distance table,
+// and an apply function that performs the move and adds that delta to the route length
+// instead of recomputing the whole tour.
+//
+// Building with TSP_CHECK_DELTAS (CMake option of the same name) cross-checks every applied
+// move against a full recompute and aborts on a mismatch.
+
+enum class MoveType {
+    Swap,      // exchange the cities at positions i and j
+    Insertion, // remove the city at position i and reinsert it at position j
+    TwoOpt     // reverse the segment between positions i and j
+};
+
+namespace moves_detail {
+inline size_t prev(size_t i, size_t n) { return i == 0 ? n - 1 : i - 1; }
+inline size_t next(size_t i, size_t n) { return i + 1 == n ? 0 : i + 1; }
+}
+
+// Change in tour length from swapping the cities at positions i and j
+inline double swapDelta(const DistanceTable &d, ConstRouteView route, size_t i, size_t j) {
+    using namespace moves_detail;
+    size_t n = route.size();
+    if (i == j || n < 4) return 0.0; // any swap in a tour of 3 cities or fewer is a rotation/reversal
+    if (i > j) std::swap(i, j);
+    if (i == 0 && j == n - 1) std::swap(i, j); // wrap-around neighbours: treat j as the predecessor
+    CityId a = route[i], b = route[j];
+    if (next(i, n) == j) {
+        CityId p = route[prev(i, n)], q = route[next(j, n)];
+        return double(d(p, b)) + d(a, q) - d(p, a) - d(b, q);
+    }
+    CityId pi = route[prev(i, n)], ni = route[next(i, n)];
+    CityId pj = route[prev(j, n)], nj = route[next(j, n)];
+    return double(d(pi, b)) + d(b, ni) + d(pj, a) + d(a, nj)
+           - d(pi, a) - d(a, ni) - d(pj, b) - d(b, nj);
+}
+
+// Change in tour length from moving the city at position `from` so that it ends up at position `to`
+inline double insertionDelta(const DistanceTable &d, ConstRouteView route, size_t from, size_t to) {
+    using namespace moves_detail;
+    size_t n = route.size();
+    if (from == to || n < 4) return 0.0;
+    if ((from == 0 && to == n - 1) || (from == n - 1 && to == 0)) return 0.0; // rotation of the tour
+    CityId c = route[from];
+    CityId p = route[prev(from, n)], q = route[next(from, n)];
+    // The city lands between x and y, the neighbours of its destination once it has been removed
+    CityId x, y;
+    if (from < to) {
+        x = route[to];
+        y = route[next(to, n)];
+    } else {
+        x = route[prev(to, n)];
+        y = route[to];
+    }
+    return double(d(p, q)) - d(p, c) - d(c, q) + d(x, c) + d(c, y) - d(x, y);
+}
+
+// Change in tour length from reversing the segment of positions [i, j]
+inline double twoOptDelta(const DistanceTable &d, ConstRouteView route, size_t i, size_t j) {
+    using namespace moves_detail;
+    size_t n = route.size();
+    if (i > j) std::swap(i, j);
+    if (j - i < 1 || j - i + 2 >= n) return 0.0; // reversing the whole tour (or all but one city) is free
+    CityId a = route[prev(i, n)], b = route[i];
+    CityId c = route[j], e = route[next(j, n)];
+    return double(d(a, c)) + d(b, e) - d(a, b) - d(c, e);
+}
+
+inline double moveDelta(MoveType type, const DistanceTable &d, ConstRouteView route, size_t i, size_t j) {
+    switch (type) {
+        case MoveType::Swap:
+            return swapDelta(d, route, i, j);
+        case MoveType::Insertion:
+            return insertionDelta(d, route, i, j);
+        case MoveType::TwoOpt:
+            return twoOptDelta(d, route, i, j);
+    }
+    return 0.0;
+}
+
+// Recompute the tour length and abort if it disagrees with the incrementally maintained one
+void checkRouteLength(const Instance &instance, ConstRouteView route, const char *move);
+
+inline void applySwap(const Instance &instance, RouteView route, size_t i, size_t j) {
+    *route.length += swapDelta(instance.distances, route, i, j);
+    route.swapPositions(i, j);
+#ifdef TSP_CHECK_DELTAS
+    checkRouteLength(instance, route, "swap");
+#endif
+}
+
+inline void applyInsertion(const Instance &instance, RouteView route, size_t from, size_t to) {
+    *route.length += insertionDelta(instance.distances, route, from, to);
+    CityId city = route.order[from];
+    if (from < to) {
+        for (size_t k = from; k < to; ++k) {
+            route.order[k] = route.order[k + 1];
+            route.position[route.order[k]] = static_cast<CityId>(k);
+        }
+    } else {
+        for (size_t k = from; k > to; --k) {
+            route.order[k] = route.order[k - 1];
+            route.position[route.order[k]] = static_cast<CityId>(k);
+        }
+    }
+    route.order[to] = city;
+    route.position[city] = static_cast<CityId>(to);
+#ifdef TSP_CHECK_DELTAS
+    checkRouteLength(instance, route, "insertion");
+#endif
+}
+
+inline void applyTwoOpt(const Instance &instance, RouteView route, size_t i, size_t j) {
+    if (i > j) std::swap(i, j);
+    *route.length += twoOptDelta(instance.distances, route, i, j);
+    for (; i < j; ++i, --j) {
+        route.swapPositions(i, j);
+    }
+#ifdef TSP_CHECK_DELTAS
+    checkRouteLength(instance, route, "2-opt");
+#endif
+}
+
+inline void applyMove(MoveType type, const Instance &instance, RouteView route, size_t i, size_t j) {
+    switch (type) {
+        case MoveType::Swap:
+            applySwap(instance, route, i, j);
+            break;
+        case MoveType::Insertion:
+            applyInsertion(instance, route, i, j);
+            break;
+        case MoveType::TwoOpt:
+            applyTwoOpt(instance, route, i, j);
+            break;
+    }
+}
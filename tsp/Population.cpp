@@ -0,0 +1,49 @@
+#include "tsp/Population.h"
+
+#include <numeric>
+#include <utility>
+
+Population::Population(size_t populationSize, size_t numCities)
+        : cities(numCities), orders(populationSize * numCities), positions(populationSize * numCities),
+          lengths(populationSize) {}
+
+size_t Population::bestIndex() const {
+    size_t best = 0;
+    for (size_t i = 1; i < lengths.size(); ++i) {
+        if (lengths[i] < lengths[best]) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+double Population::meanLength() const {
+    return std::accumulate(lengths.begin(), lengths.end(), 0.0) / lengths.size();
+}
+
+double Population::diversity() const {
+    if (cities < 3 || lengths.empty()) {
+        return 0.0;
+    }
+    ConstRouteView best = route(bestIndex());
+    size_t missing = 0;
+    for (size_t r = 0; r < size(); ++r) {
+        ConstRouteView other = route(r);
+        for (size_t i = 0; i < cities; ++i) {
+            // Edge (a, b) of the best route is in `other` if b sits next to a there
+            size_t at = other.positionOf(best[i]);
+            CityId b = best[i + 1 == cities ? 0 : i + 1];
+            CityId before = other[at == 0 ? cities - 1 : at - 1];
+            CityId after = other[at + 1 == cities ? 0 : at + 1];
+            missing += before != b && after != b;
+        }
+    }
+    return static_cast<double>(missing) / (static_cast<double>(cities) * size());
+}
+
+void Population::swap(Population &other) noexcept {
+    std::swap(cities, other.cities);
+    orders.swap(other.orders);
+    positions.swap(other.positions);
+    lengths.swap(other.lengths);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "tsp/Route.h"
+
+// Fixed-size population stored as flat arenas: the city orders (and inverse permutations) of
+// all routes back to back, plus one tour length per route. Routes are accessed by index through
+// views, so a generation can write each child straight into its slot of a preallocated buffer.
+// The GA keeps two populations and swaps them every generation, which costs no heap allocation.
+class Population {
+public:
+    Population() = default;
+    Population(size_t populationSize, size_t numCities);
+
+    size_t size() const { return lengths.size(); }
+    size_t numCities() const { return cities; }
+
+    RouteView route(size_t i) {
+        return {&orders[i * cities], &positions[i * cities], cities, &lengths[i]};
+    }
+
+    ConstRouteView route(size_t i) const {
+        return {&orders[i * cities], &positions[i * cities], cities, lengths[i]};
+    }
+
+    double length(size_t i) const { return lengths[i]; }
+
+    // Index of the shortest route
+    size_t bestIndex() const;
+
+    double meanLength() const;
+
+    // Average fraction of the best route's edges that a route does not use:
+    // 0 when all routes are the same tour, close to 1 for unrelated random tours
+    double diversity() const;
+
+    void swap(Population &other) noexcept;
+
+private:
+    size_t cities = 0;
+    std::vector<CityId> orders;
+    std::vector<CityId> positions;
+    std::vector<double> lengths;
+};
@@ -0,0 +1,63 @@
+#include "tsp/Route.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include "common/Profiler.h"
+
+void checkCityIdWidth(const Instance &instance) {
+    if (instance.size() - 1 > std::numeric_limits<CityId>::max()) {
+        throw std::length_error("instance has too many cities for the configured CityId width");
+    }
+}
+
+void RouteView::assign(ConstRouteView other) const {
+    GA_PROFILE_ZONE(Copy);
+    std::copy(other.order, other.order + n, order);
+    std::copy(other.position, other.position + n, position);
+    *length = other.length;
+}
+
+void RouteView::rebuildPositions() const {
+    for (size_t i = 0; i < n; ++i) {
+        position[order[i]] = static_cast<CityId>(i);
+    }
+}
+
+void RouteView::calculateFitness(const Instance &instance) const {
+    GA_PROFILE_ZONE(Evaluation);
+    *length = instance.distances.tourLength(order, n);
+}
+
+Route::Route(const Instance &instance, std::vector<CityId> order) : order(std::move(order)) {
+    checkCityIdWidth(instance);
+    position.resize(this->order.size());
+    view().rebuildPositions();
+    view().calculateFitness(instance);
+}
+
+Route::Route(ConstRouteView other)
+        : order(other.order, other.order + other.n), position(other.position, other.position + other.n),
+          length(other.length) {}
+
+void printRoute(std::ostream &os, const Instance &instance, const Route &route) {
+    os << "Best route: ";
+    if (route.size() > PRINT_ROUTE_LIMIT) {
+        os << "(" << route.size() << " cities, not printed)\n";
+    } else if (!instance.hasCoordinates()) {
+        // Explicit instances without display coordinates: print the 1-based TSPLIB city numbers
+        for (CityId index: route.order) {
+            os << index + 1 << " -> ";
+        }
+        os << route.order.front() + 1 << '\n';
+    } else {
+        for (CityId index: route.order) {
+            const City &city = instance.cities[index];
+            os << '(' << city.x << ", " << city.y << ") -> ";
+        }
+        const City &first = instance.cities[route.order.front()];
+        os << '(' << first.x << ", " << first.y << ")\n";
+    }
+    os << "Total distance: " << route.totalDistance() << std::endl;
+}
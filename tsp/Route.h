@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "tsp/Instance.h"
+
+// Compact city identifier used by routes. 16-bit ids halve the memory footprint of a
+// population (instances of up to 65535 cities) when built with TSP_COMPACT_CITY_IDS.
+#ifdef TSP_COMPACT_CITY_IDS
+using CityId = uint16_t;
+#else
+using CityId = uint32_t;
+#endif
+
+// Throws std::length_error if the instance has more cities than CityId can number
+void checkCityIdWidth(const Instance &instance);
+
+// Read-only view of a route stored elsewhere (a Route or a Population slot)
+struct ConstRouteView {
+    const CityId *order;
+    const CityId *position;
+    size_t n;
+    double length;
+
+    size_t size() const { return n; }
+    CityId operator[](size_t i) const { return order[i]; }
+    size_t positionOf(CityId city) const { return position[city]; }
+};
+
+// Mutable view of a route stored elsewhere. A route is a permutation of city ids, together
+// with its tour length. `position` is the inverse permutation (position[order[i]] == i) and is
+// kept in sync by swapPositions, so locating a city in the route is O(1).
+struct RouteView {
+    CityId *order;
+    CityId *position;
+    size_t n;
+    // Length of the closed tour; move operators update it incrementally (see tsp/Moves.h)
+    double *length;
+
+    operator ConstRouteView() const { return {order, position, n, *length}; }
+
+    size_t size() const { return n; }
+    CityId operator[](size_t i) const { return order[i]; }
+    size_t positionOf(CityId city) const { return position[city]; }
+
+    // Swap the cities at positions i and j, keeping the inverse permutation up to date
+    void swapPositions(size_t i, size_t j) const {
+        std::swap(order[i], order[j]);
+        position[order[i]] = static_cast<CityId>(i);
+        position[order[j]] = static_cast<CityId>(j);
+    }
+
+    // Make this route a copy of another one of the same size
+    void assign(ConstRouteView other) const;
+
+    // Rebuild the inverse permutation after `order` has been written directly
+    void rebuildPositions() const;
+
+    // Method to recalculate the tour length from scratch
+    void calculateFitness(const Instance &instance) const;
+};
+
+// Class to represent a standalone route (e.g. the best route of a run) that owns its storage
+class Route {
+public:
+    std::vector<CityId> order;
+    std::vector<CityId> position;
+    double length = 0.0;
+
+    Route() = default;
+
+    // Constructor to initialize the city order and calculate the tour length
+    Route(const Instance &instance, std::vector<CityId> order);
+
+    // Owning copy of a route stored elsewhere
+    explicit Route(ConstRouteView other);
+
+    RouteView view() { return {order.data(), position.data(), order.size(), &length}; }
+    ConstRouteView view() const { return {order.data(), position.data(), order.size(), length}; }
+
+    size_t size() const { return order.size(); }
+    CityId operator[](size_t i) const { return order[i]; }
+
+    // Fitness score of the route (inverse of the closed tour length)
+    double fitness() const { return 1.0 / length; }
+
+    // Total length of the closed tour
+    double totalDistance() const { return length; }
+};
+
+// Routes with more cities than this are summarized instead of printed city by city
+const size_t PRINT_ROUTE_LIMIT = 1000;
+
+// Print the route as a closed tour followed by its total distance
+void printRoute(std::ostream &os, const Instance &instance, const Route &route);
@@ -0,0 +1,148 @@
+#include "tsp/Seeding.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Side of the square grid that space-filling-curve coordinates are quantized to
+static const int HILBERT_ORDER = 16;
+
+// Position of the cell (x, y) along the Hilbert curve that fills a 2^HILBERT_ORDER square
+static uint64_t hilbertIndex(uint32_t x, uint32_t y) {
+    const uint32_t side = uint32_t(1) << HILBERT_ORDER;
+    uint64_t index = 0;
+    for (uint32_t s = side / 2; s > 0; s /= 2) {
+        uint32_t rx = (x & s) != 0, ry = (y & s) != 0;
+        index += uint64_t(s) * s * ((3 * rx) ^ ry);
+        // Rotate the quadrant so the curve inside it runs in the standard orientation
+        if (ry == 0) {
+            if (rx == 1) {
+                x = side - 1 - x;
+                y = side - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return index;
+}
+
+// Per-thread working memory, reused across tours
+struct SeedingScratch {
+    std::vector<uint8_t> taken;
+    std::vector<uint32_t> remaining;
+    std::vector<CityId> unvisited;
+    std::vector<std::pair<uint64_t, CityId>> keys;
+};
+
+static SeedingScratch &seedingScratch() {
+    static thread_local SeedingScratch scratch;
+    return scratch;
+}
+
+TourSeeding parseTourSeeding(const std::string &name) {
+    if (name == "random") return TourSeeding::Random;
+    if (name == "nn") return TourSeeding::NearestNeighbour;
+    if (name == "sfc") return TourSeeding::SpaceFillingCurve;
+    if (name == "mixed") return TourSeeding::Mixed;
+    throw std::invalid_argument("unknown seeding '" + name + "' (expected random, nn, sfc or mixed)");
+}
+
+TourSeeder::TourSeeder(const Instance &instance, TourSeeding seeding) : instance(instance), seeding(seeding) {
+    bool planar = instance.hasCoordinates() && instance.distances.metric() != Metric::Explicit;
+    if (seeding != TourSeeding::Random && planar) {
+        grid = std::make_unique<SpatialGrid>(instance.cities);
+    }
+}
+
+void TourSeeder::build(RouteView route, size_t i, Rng &rng) const {
+    TourSeeding kind = seeding;
+    if (kind == TourSeeding::Mixed) {
+        kind = i % 3 == 0 ? TourSeeding::NearestNeighbour
+                          : i % 3 == 1 ? TourSeeding::SpaceFillingCurve : TourSeeding::Random;
+    }
+    if (kind == TourSeeding::SpaceFillingCurve && !grid) {
+        kind = TourSeeding::NearestNeighbour;
+    }
+    if (route.size() < 3) {
+        kind = TourSeeding::Random;
+    }
+    switch (kind) {
+        case TourSeeding::NearestNeighbour:
+            nearestNeighbourTour(route, rng);
+            break;
+        case TourSeeding::SpaceFillingCurve:
+            spaceFillingCurveTour(route, rng);
+            break;
+        default:
+            // Shuffle the cities randomly
+            std::iota(route.order, route.order + route.size(), 0);
+            std::shuffle(route.order, route.order + route.size(), rng);
+            break;
+    }
+    route.rebuildPositions();
+}
+
+void TourSeeder::nearestNeighbourTour(RouteView route, Rng &rng) const {
+    size_t n = route.size();
+    SeedingScratch &s = seedingScratch();
+    auto current = static_cast<CityId>(rng.below(static_cast<uint32_t>(n)));
+    route.order[0] = current;
+    if (grid) {
+        s.taken.assign(n, 0);
+        grid->cellCounts(s.remaining);
+        for (size_t k = 1;; ++k) {
+            s.taken[current] = 1;
+            --s.remaining[grid->cellOf(current)];
+            if (k == n) break;
+            current = static_cast<CityId>(grid->nearestFree(current, s.taken, s.remaining));
+            route.order[k] = current;
+        }
+        return;
+    }
+    // No coordinates: scan the unvisited cities for the closest one, O(n^2) in total
+    const DistanceTable &d = instance.distances;
+    s.unvisited.resize(n);
+    std::iota(s.unvisited.begin(), s.unvisited.end(), 0);
+    std::swap(s.unvisited[current], s.unvisited[n - 1]);
+    for (size_t left = n - 1, k = 1; left > 0; --left, ++k) {
+        size_t best = 0;
+        for (size_t j = 1; j < left; ++j) {
+            if (d(current, s.unvisited[j]) < d(current, s.unvisited[best])) best = j;
+        }
+        current = s.unvisited[best];
+        s.unvisited[best] = s.unvisited[left - 1];
+        route.order[k] = current;
+    }
+}
+
+void TourSeeder::spaceFillingCurveTour(RouteView route, Rng &rng) const {
+    const std::vector<City> &cities = instance.cities;
+    size_t n = route.size();
+    // Rotating the plane by a random angle gives every tour a differently laid curve
+    double angle = 2.0 * M_PI * rng.uniform();
+    double cosA = std::cos(angle), sinA = std::sin(angle);
+    std::vector<std::pair<uint64_t, CityId>> &keys = seedingScratch().keys;
+    keys.resize(n);
+    double minU = INFINITY, minV = INFINITY, maxU = -INFINITY, maxV = -INFINITY;
+    for (const City &city: cities) {
+        double u = city.x * cosA - city.y * sinA, v = city.x * sinA + city.y * cosA;
+        minU = std::min(minU, u);
+        maxU = std::max(maxU, u);
+        minV = std::min(minV, v);
+        maxV = std::max(maxV, v);
+    }
+    double scale = double((uint32_t(1) << HILBERT_ORDER) - 1) / std::max({maxU - minU, maxV - minV, 1e-9});
+    for (size_t c = 0; c < n; ++c) {
+        double u = cities[c].x * cosA - cities[c].y * sinA, v = cities[c].x * sinA + cities[c].y * cosA;
+        auto x = static_cast<uint32_t>((u - minU) * scale), y = static_cast<uint32_t>((v - minV) * scale);
+        keys[c] = {hilbertIndex(x, y), static_cast<CityId>(c)};
+    }
+    std::sort(keys.begin(), keys.end());
+    for (size_t k = 0; k < n; ++k) {
+        route.order[k] = keys[k].second;
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "common/Random.h"
+#include "tsp/Instance.h"
+#include "tsp/Route.h"
+#include "tsp/SpatialGrid.h"
+
+// How the initial population is built
+enum class TourSeeding {
+    Random,            // uniformly random permutations
+    NearestNeighbour,  // greedy nearest-neighbour tours, each from a random start city
+    SpaceFillingCurve, // cities in Hilbert-curve order, the curve laid at a random angle per tour
+    Mixed              // nearest-neighbour, space-filling-curve and random tours in turn
+};
+
+// Parse "random", "nn", "sfc" or "mixed"; throws on anything else
+TourSeeding parseTourSeeding(const std::string &name);
+
+// Builds initial tours. The spatial index over the coordinates is built once and only read
+// afterwards, so tours can be built concurrently, each with its own random stream. Instances
+// without coordinates get nearest-neighbour tours from the distance matrix instead of
+// space-filling-curve tours.
+class TourSeeder {
+public:
+    TourSeeder(const Instance &instance, TourSeeding seeding);
+
+    // Write the i-th initial tour of the population into `route` and rebuild its positions;
+    // the length is left to the caller
+    void build(RouteView route, size_t i, Rng &rng) const;
+
+private:
+    const Instance &instance;
+    TourSeeding seeding;
+    std::unique_ptr<SpatialGrid> grid; // only for seeded tours of instances with coordinates
+
+    void nearestNeighbourTour(RouteView route, Rng &rng) const;
+    void spaceFillingCurveTour(RouteView route, Rng &rng) const;
+};
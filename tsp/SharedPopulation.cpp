@@ -0,0 +1,75 @@
+#include "tsp/SharedPopulation.h"
+
+#include "common/Profiler.h"
+
+SharedPopulation::SharedPopulation(const Population &initial)
+        : count(initial.size()), cities(initial.numCities()), slots(new Slot[initial.size()]),
+          orders(new std::atomic<CityId>[initial.size() * initial.numCities()]) {
+    for (size_t i = 0; i < count; ++i) {
+        ConstRouteView route = initial.route(i);
+        for (size_t k = 0; k < cities; ++k) {
+            orders[i * cities + k].store(route[k], std::memory_order_relaxed);
+        }
+        slots[i].length.store(route.length, std::memory_order_relaxed);
+    }
+    // Publish the initial contents to the threads that are started afterwards
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void SharedPopulation::read(size_t i, RouteView dst) const {
+    GA_PROFILE_ZONE(Copy);
+    const Slot &slot = slots[i];
+    const std::atomic<CityId> *order = &orders[i * cities];
+    while (true) {
+        uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue; // being written
+        }
+        for (size_t k = 0; k < cities; ++k) {
+            dst.order[k] = order[k].load(std::memory_order_relaxed);
+        }
+        *dst.length = slot.length.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == before) {
+            break;
+        }
+    }
+    dst.rebuildPositions();
+}
+
+bool SharedPopulation::tryReplace(size_t i, ConstRouteView route) {
+    GA_PROFILE_ZONE(Replacement);
+    Slot &slot = slots[i];
+    uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    if ((sequence & 1) || !slot.sequence.compare_exchange_strong(sequence, sequence + 1, std::memory_order_acquire)) {
+        return false; // another writer has the slot
+    }
+    // Keep the odd sequence number visible before any of the new data
+    std::atomic_thread_fence(std::memory_order_release);
+    bool better = route.length < slot.length.load(std::memory_order_relaxed);
+    if (better) {
+        std::atomic<CityId> *order = &orders[i * cities];
+        for (size_t k = 0; k < cities; ++k) {
+            order[k].store(route[k], std::memory_order_relaxed);
+        }
+        slot.length.store(route.length, std::memory_order_relaxed);
+    }
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    return better;
+}
+
+size_t SharedPopulation::bestIndex() const {
+    size_t best = 0;
+    for (size_t i = 1; i < count; ++i) {
+        if (length(i) < length(best)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+void SharedPopulation::snapshot(Population &dst) const {
+    for (size_t i = 0; i < count; ++i) {
+        read(i, dst.route(i));
+    }
+}
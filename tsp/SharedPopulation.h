@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "tsp/Population.h"
+#include "tsp/Route.h"
+
+// Population that worker threads read and replace concurrently without locks or barriers.
+// Every slot is guarded by a seqlock: a writer makes the slot's sequence number odd, writes the
+// city order and length, and makes it even again; a reader copies the slot and retries if the
+// sequence number was odd or changed meanwhile. Readers therefore never block writers, and a
+// writer only ever contends with another writer that picked the same slot, in which case one of
+// them gives up instead of waiting. City ids are stored as relaxed atomics, which compile to plain
+// loads and stores but keep the concurrent copies well defined.
+class SharedPopulation {
+public:
+    explicit SharedPopulation(const Population &initial);
+
+    size_t size() const { return count; }
+    size_t numCities() const { return cities; }
+
+    // Length of slot i as last published; may be replaced at any moment
+    double length(size_t i) const { return slots[i].length.load(std::memory_order_relaxed); }
+
+    // Consistent copy of slot i (order, positions and length) into `dst`
+    void read(size_t i, RouteView dst) const;
+
+    // Overwrite slot i with `route` if the slot is not being written and still holds a longer route;
+    // returns whether the route was published
+    bool tryReplace(size_t i, ConstRouteView route);
+
+    size_t bestIndex() const;
+
+    // Consistent copy of every slot (each slot on its own; other slots may change meanwhile)
+    void snapshot(Population &dst) const;
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<double> length{0.0};
+    };
+
+    size_t count;
+    size_t cities;
+    std::unique_ptr<Slot[]> slots;
+    std::unique_ptr<std::atomic<CityId>[]> orders;
+};
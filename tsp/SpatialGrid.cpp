@@ -0,0 +1,144 @@
+#include "tsp/SpatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <utility>
+
+// Average number of cities per cell
+static const double CITIES_PER_CELL = 2.0;
+
+SpatialGrid::SpatialGrid(const std::vector<City> &cities) : cities(cities) {
+    if (cities.empty()) {
+        cellStart.assign(2, 0);
+        return;
+    }
+    double maxX = cities[0].x, maxY = cities[0].y;
+    minX = cities[0].x;
+    minY = cities[0].y;
+    for (const City &city: cities) {
+        minX = std::min(minX, city.x);
+        minY = std::min(minY, city.y);
+        maxX = std::max(maxX, city.x);
+        maxY = std::max(maxY, city.y);
+    }
+    double width = std::max(maxX - minX, 1e-9), height = std::max(maxY - minY, 1e-9);
+    cellSize = std::sqrt(width * height * CITIES_PER_CELL / static_cast<double>(cities.size()));
+    // Degenerate (collinear) layouts would give a zero-area estimate
+    cellSize = std::max(cellSize, std::max(width, height) * CITIES_PER_CELL / static_cast<double>(cities.size()));
+    cols = static_cast<size_t>(width / cellSize) + 1;
+    rows = static_cast<size_t>(height / cellSize) + 1;
+
+    // Counting sort of the cities by cell
+    cellStart.assign(cols * rows + 1, 0);
+    std::vector<uint32_t> home(cities.size());
+    for (size_t i = 0; i < cities.size(); ++i) {
+        home[i] = static_cast<uint32_t>(cellOf(i));
+        ++cellStart[home[i] + 1];
+    }
+    for (size_t c = 0; c < cols * rows; ++c) {
+        cellStart[c + 1] += cellStart[c];
+    }
+    cellCities.resize(cities.size());
+    std::vector<uint32_t> fill(cellStart.begin(), cellStart.end() - 1);
+    for (size_t i = 0; i < cities.size(); ++i) {
+        cellCities[fill[home[i]]++] = static_cast<uint32_t>(i);
+    }
+}
+
+size_t SpatialGrid::column(double x) const {
+    return std::min(cols - 1, static_cast<size_t>((x - minX) / cellSize));
+}
+
+size_t SpatialGrid::row(double y) const {
+    return std::min(rows - 1, static_cast<size_t>((y - minY) / cellSize));
+}
+
+template<typename Scan, typename Done>
+void SpatialGrid::scanRings(size_t from, Scan scan, Done done) const {
+    long cx = static_cast<long>(column(cities[from].x)), cy = static_cast<long>(row(cities[from].y));
+    auto visit = [&](long x, long y) {
+        if (x >= 0 && y >= 0 && x < static_cast<long>(cols) && y < static_cast<long>(rows)) {
+            scan(static_cast<size_t>(y) * cols + static_cast<size_t>(x));
+        }
+    };
+    long maxRing = static_cast<long>(std::max(cols, rows));
+    for (long r = 0; r <= maxRing; ++r) {
+        if (r == 0) {
+            visit(cx, cy);
+        } else {
+            for (long x = cx - r; x <= cx + r; ++x) {
+                visit(x, cy - r);
+                visit(x, cy + r);
+            }
+            for (long y = cy - r + 1; y <= cy + r - 1; ++y) {
+                visit(cx - r, y);
+                visit(cx + r, y);
+            }
+        }
+        // Every cell of ring r + 1 is at least r cells away from the origin
+        if (done(static_cast<double>(r) * cellSize)) {
+            break;
+        }
+    }
+}
+
+void SpatialGrid::nearest(size_t from, size_t k, std::vector<uint32_t> &out) const {
+    out.clear();
+    k = std::min(k, cities.size() - 1);
+    if (k == 0) {
+        return;
+    }
+    const City &origin = cities[from];
+    // Max-heap of the k best candidates so far by squared distance
+    std::priority_queue<std::pair<double, uint32_t>> best;
+    auto scan = [&](size_t cell) {
+        for (uint32_t c = cellStart[cell]; c < cellStart[cell + 1]; ++c) {
+            uint32_t city = cellCities[c];
+            if (city == from) continue;
+            double dx = cities[city].x - origin.x, dy = cities[city].y - origin.y;
+            double d2 = dx * dx + dy * dy;
+            if (best.size() < k) {
+                best.emplace(d2, city);
+            } else if (d2 < best.top().first) {
+                best.pop();
+                best.emplace(d2, city);
+            }
+        }
+    };
+    scanRings(from, scan, [&](double reach) { return best.size() == k && best.top().first <= reach * reach; });
+    out.resize(best.size());
+    for (size_t i = best.size(); i-- > 0;) {
+        out[i] = best.top().second;
+        best.pop();
+    }
+}
+
+void SpatialGrid::cellCounts(std::vector<uint32_t> &counts) const {
+    counts.resize(numCells());
+    for (size_t c = 0; c < numCells(); ++c) {
+        counts[c] = cellStart[c + 1] - cellStart[c];
+    }
+}
+
+long SpatialGrid::nearestFree(size_t from, const std::vector<uint8_t> &taken,
+                              const std::vector<uint32_t> &remaining) const {
+    const City &origin = cities[from];
+    long best = -1;
+    double bestD2 = 0.0;
+    auto scan = [&](size_t cell) {
+        if (remaining[cell] == 0) return;
+        for (uint32_t c = cellStart[cell]; c < cellStart[cell + 1]; ++c) {
+            uint32_t city = cellCities[c];
+            if (taken[city]) continue;
+            double dx = cities[city].x - origin.x, dy = cities[city].y - origin.y;
+            double d2 = dx * dx + dy * dy;
+            if (best < 0 || d2 < bestD2) {
+                best = city;
+                bestD2 = d2;
+            }
+        }
+    };
+    scanRings(from, scan, [&](double reach) { return best >= 0 && bestD2 <= reach * reach; });
+    return best;
+}
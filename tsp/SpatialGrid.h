@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "tsp/City.h"
+
+// Uniform grid over city coordinates for nearest-neighbour queries. Cells are sized for about
+// two cities each and store their cities contiguously (CSR layout), so a query scans rings of
+// cells around the query point and stops as soon as no unscanned cell can hold anything closer.
+// Distances are plain Euclidean in coordinate space, which ranks neighbours exactly for every
+// planar metric and approximately for GEO coordinates.
+class SpatialGrid {
+public:
+    explicit SpatialGrid(const std::vector<City> &cities);
+
+    // The (up to) k cities nearest to city `from`, itself excluded, nearest first.
+    // Safe to call concurrently.
+    void nearest(size_t from, size_t k, std::vector<uint32_t> &out) const;
+
+    size_t numCells() const { return cols * rows; }
+    size_t cellOf(size_t city) const { return row(cities[city].y) * cols + column(cities[city].x); }
+
+    // Number of cities in every cell, the starting state of `remaining` below
+    void cellCounts(std::vector<uint32_t> &counts) const;
+
+    // Nearest city to `from` that is not `taken`, for tours built one city at a time. `remaining`
+    // holds the number of untaken cities per cell so that emptied cells are skipped without
+    // looking at their cities. Returns -1 once every city is taken.
+    long nearestFree(size_t from, const std::vector<uint8_t> &taken, const std::vector<uint32_t> &remaining) const;
+
+private:
+    const std::vector<City> &cities;
+    double minX = 0.0, minY = 0.0;
+    double cellSize = 1.0;
+    size_t cols = 1, rows = 1;
+    std::vector<uint32_t> cellStart; // cities of cell c are cellCities[cellStart[c] .. cellStart[c + 1])
+    std::vector<uint32_t> cellCities;
+
+    size_t column(double x) const;
+    size_t row(double y) const;
+
+    // Call scan(cell) for the cells around city `from` ring by ring, until the ring just scanned
+    // satisfies done(r * cellSize), i.e. nothing closer than that distance can be left unseen
+    template<typename Scan, typename Done>
+    void scanRings(size_t from, Scan scan, Done done) const;
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "tsp/DistanceTable.h"
+#include "tsp/Route.h"
+
+// Batched tour-length evaluation. Each SIMD lane walks a different tour, so a batch of TOUR_BATCH
+// tours is evaluated with one gather per edge position (from the dense matrix, or from the
+// coordinates for Euclidean and EUC_2D instances beyond DistanceTable::DENSE_LIMIT) instead of one
+// scalar lookup per edge of every tour. Every lane adds up its edges in the same order and in the
+// same block structure as DistanceTable::tourLength, so the lengths are bit-identical to it (the
+// engine is built with -ffp-contract=off, so neither side fuses multiply-adds).
+//
+// The kernel is picked at run time from what the CPU supports: AVX2 (4 tours per step) or else the
+// scalar tourLength. AVX-512 (8 tours per step) can be selected explicitly. Metrics without a vector
+// formula (CEIL_2D, ATT and GEO beyond the dense limit) always use the scalar one.
+
+// Number of tours callers should gather before evaluating them
+static const size_t TOUR_BATCH = 8;
+
+// Lengths of `count` closed tours of n cities each into lengths[0..count)
+void batchTourLengths(const DistanceTable &distances, const CityId *const *orders, size_t count, size_t n,
+                      double *lengths);
+
+// Kernel batchTourLengths uses: "avx512", "avx2" or "scalar"
+const char *tourBatchKernel();
+
+// Override the kernel choice with "auto" (AVX2 if the CPU has it), "avx512", "avx2" or "scalar";
+// throws std::invalid_argument for unknown names and for instructions the CPU does not have
+void selectTourBatchKernel(const std::string &name);